@@ -49,6 +49,12 @@
  *    - Priority: 优先级，根据需要选择（Medium或High）
  *    - Mode: 选择 Normal (单次传输)
  *    - 其他参数保持默认即可
+ *    - 在HAL_SPI_TxCpltCallback中调用AD840X_SPI_TxCpltCallback(hspi)（见main.c），DMA模式下由它拉高CS
+ *    双SPI总线（可选）：
+ *    - 再开启SPI2（PB13 SCK/PB15 MOSI，SPI2_TX对应DMA1 Channel5），参数同SPI1
+ *    - SPI2在APB1上，36MHz时用4分频（9MHz），也可以用AD840X_SPI_PlanClock自动选择
+ *    - 把设备分别挂到hspi1和hspi2上，用AD840X_WriteBatch同时发送两条总线上的更新
+ *    - 注意本例程的PB13/PB14被用作SHDN2/CS3，启用SPI2前需要把它们换到其他引脚
  * 3. 引脚分配：
  *    - SCK:  指定时钟引脚
  *    - MOSI: 指定数据输出
@@ -145,10 +151,212 @@ extern "C"
 #define AD840X_50K_OHM 50000.0f   // 50kΩ型号
 #define AD840X_100K_OHM 100000.0f // 100kΩ型号
 
-    /* 设备句柄结构体定义 */
+/* 滑动端电阻RW（Table1，典型值） */
+#define AD840X_R_WIPER_OHM 50.0f
+
+/* 编译时换算为8位控制值（超出范围时钳制到0或255）
+ * 参数都是常量时整个表达式在编译时算完，例如
+ *    AD840X_Write(&hAD840X_1, AD840X_CHANNEL_1, AD840X_RESISTANCE_CODE(2500.0f, AD840X_10K_OHM));
+ * 编译成直接写入64，运行时没有浮点运算。参数会被求值多次，不要传带副作用的表达式。
+ * AD840X_RATIO_CODE与AD840X_CalculateRatio、AD840X_RESISTANCE_CODE与AD840X_WriteResistance的结果完全相同，
+ * AD840X_RWB_CODE按数据手册公式RWB(D) = D / 256 × RAB + RW计入滑动端电阻，适合对B端阻值有要求的场合。
+ * C++中也可以用AD840X.hpp中的constexpr函数。
+ */
+#define AD840X_CODE_ROUND(x) ((uint8_t)((x) <= 0.0f ? 0U : (x) >= 255.0f ? 255U : (uint32_t)((x) + 0.5f)))
+#define AD840X_RATIO_CODE(ratio) AD840X_CODE_ROUND((float)(ratio) * 255.0f)
+#define AD840X_RESISTANCE_CODE(resistance, full_scale) \
+    AD840X_CODE_ROUND((float)(resistance) / (float)(full_scale) * 255.0f)
+#define AD840X_RWB_CODE(resistance, full_scale) \
+    AD840X_CODE_ROUND(((float)(resistance) - AD840X_R_WIPER_OHM) * 256.0f / (float)(full_scale))
+
+/* SPI时钟上限（Page1 Features） */
+#define AD840X_SPI_MAX_CLOCK_HZ 10000000U
+
+/* 时序参数（Page10 Table4, Page4 Table1） */
+#define AD840X_T_RS_NS 50       // RS复位脉冲宽度tRS
+#define AD840X_T_SETTLE_NS 2000 // 退出断电模式后的稳定时间ts（10kΩ）
+
+/* 中间值（RS复位后的滑动端位置，Page12） */
+#define AD840X_MIDSCALE 128
+
+/* 写入路径的编译时选择
+ * 默认每次写入时按设备判断回读校验、DMA队列还是阻塞发送，并通过后端操作表调用；
+ * 工程里所有设备都用同一种方式时，定义AD840X_POLICY为下面的某一项，AD840X_Write只编译这一条路径：
+ *    AD840X_POLICY_BLOCKING  阻塞发送，经过后端操作表（HAL、LL、GPIO模拟SPI、Linux仿真的器件模型）
+ *    AD840X_POLICY_REG       阻塞发送，CS直接写BSRR、数据直接写SPI的DR，不经过操作表；
+ *                            AD840X_Init自动改用寄存器后端，AD840X_Init_Transport只能传AD840X_Transport_Reg
+ *                            （并行GPIO、LL、GPIO模拟SPI和仿真后端会调用Error_Handler）
+ *    AD840X_POLICY_DMA       进入总线队列，后端必须支持DMA（否则初始化时调用Error_Handler）
+ * 固定路径后AD840X_Config_Verify不再起作用。例如在platformio.ini的build_flags中加入
+ *    -D AD840X_POLICY=AD840X_POLICY_REG
+ */
+#define AD840X_POLICY_RUNTIME 0
+#define AD840X_POLICY_BLOCKING 1
+#define AD840X_POLICY_REG 2
+#define AD840X_POLICY_DMA 3
+#ifndef AD840X_POLICY
+#define AD840X_POLICY AD840X_POLICY_RUNTIME
+#endif
+
+    /* AD840X型号定义
+     * 枚举值即该型号实际拥有的通道数（Page1 Features）
+     */
+    typedef enum
+    {
+        AD840X_MODEL_AD8400 = 1, // 单通道
+        AD840X_MODEL_AD8402 = 2, // 双通道
+        AD840X_MODEL_AD8403 = 4  // 四通道
+    } AD840X_ModelTypeDef;
+
+/* 可注册的SPI总线数量（STM32F103C8有SPI1和SPI2）
+ * 定义AD840X_USE_RTOS时每个不同的transport_ctx都注册一条总线（见AD840X_OS.h） */
+#ifndef AD840X_MAX_BUSES
+#define AD840X_MAX_BUSES 2
+#endif
+
+/* 每条总线DMA待发送帧队列长度，必须是2的幂 */
+#ifndef AD840X_BUS_QUEUE_SIZE
+#define AD840X_BUS_QUEUE_SIZE 16
+#endif
+
+/* 每条总线高优先级帧队列长度（见AD840X_WriteUrgent），必须是2的幂 */
+#ifndef AD840X_BUS_URGENT_SIZE
+#define AD840X_BUS_URGENT_SIZE 4
+#endif
+
+    /* 写入优先级：每个优先级一个队列，帧间隙处总是先发高优先级队列 */
+    typedef enum
+    {
+        AD840X_PRIORITY_NORMAL = 0, // 普通写入（AD840X_Write/AD840X_WriteAsync）
+        AD840X_PRIORITY_HIGH = 1,   // 紧急写入（AD840X_WriteUrgent），例如静音、安全关断
+        AD840X_PRIORITY_COUNT
+    } AD840X_PriorityTypeDef;
+
+    struct __AD840X_HandleTypeDef;
+
+    /* 异步写完成回调（见AD840X_WriteAsync），DMA后端一般在发送完成中断中调用；
+     * DMA没能启动或帧已被取消时在启动发送的上下文中调用（可能是任务，并占有总线互斥量）
+     * status: HAL_OK-帧已锁存，HAL_ERROR-传输出错，帧被丢弃 */
+    typedef void (*AD840X_CallbackTypeDef)(struct __AD840X_HandleTypeDef *hdev, HAL_StatusTypeDef status,
+                                           void *arg);
+
+    /* DMA待发送帧 */
     typedef struct
     {
-        SPI_HandleTypeDef *hspi; // SPI句柄
+        struct __AD840X_HandleTypeDef *hdev; // 目标设备
+        uint8_t tx[2];                       // 帧数据（DMA直接从这里发送）
+        volatile uint8_t status;             // 完成状态（HAL_StatusTypeDef），槽位被复用前有效
+        volatile uint8_t cancel;             // 被高优先级写入取消，轮到时不发送
+        uint32_t seq;                        // 帧序号
+        uint32_t mark;                       // 高优先级帧：提交时普通队列已完成的帧数
+        AD840X_CallbackTypeDef callback;     // 完成回调，不需要时为NULL
+        void *arg;                           // 回调参数
+#ifdef AD840X_USE_TRACE
+        uint32_t trace; // 跟踪记录序号，见AD840X_Trace.h
+#endif
+    } AD840X_FrameTypeDef;
+
+    /* 传输后端操作表，驱动的所有硬件访问都通过它完成，不同后端可以替换底层实现
+     * 已提供的后端见AD840X_Transport.h
+     */
+    typedef struct
+    {
+        /* 控制CS：active=1拉低选中，active=0拉高释放 */
+        void (*Select)(struct __AD840X_HandleTypeDef *hdev, uint8_t active);
+        /* 阻塞发送size字节 */
+        HAL_StatusTypeDef (*Transmit)(struct __AD840X_HandleTypeDef *hdev, const uint8_t *data, uint16_t size);
+        /* 阻塞全双工收发（回读校验用），不支持时为NULL */
+        HAL_StatusTypeDef (*TransmitReceive)(struct __AD840X_HandleTypeDef *hdev, const uint8_t *tx,
+                                             uint8_t *rx, uint16_t size);
+        /* 启动异步发送，完成后由后端调用AD840X_Transport_TxComplete；不支持时为NULL */
+        HAL_StatusTypeDef (*Transmit_DMA)(struct __AD840X_HandleTypeDef *hdev, const uint8_t *data, uint16_t size);
+        /* 控制SHDN/RS等GPIO引脚：level=1高电平，level=0低电平 */
+        void (*Pin_Write)(struct __AD840X_HandleTypeDef *hdev, GPIO_TypeDef *port, uint16_t pin, uint8_t level);
+        /* 延时至少ns纳秒 */
+        void (*Delay)(struct __AD840X_HandleTypeDef *hdev, uint32_t ns);
+    } AD840X_TransportTypeDef;
+
+    /* 一个优先级的待发送帧队列 */
+    typedef struct
+    {
+        AD840X_FrameTypeDef *frames; // 帧数组（指向总线内的存储）
+        uint32_t mask;               // 队列长度-1
+        volatile uint32_t head;      // 写入计数（任务侧修改），即下一帧的序号
+        volatile uint32_t tail;      // 读出计数（DMA完成中断侧修改），即已完成的帧数
+    } AD840X_LaneTypeDef;
+
+    /* SPI总线结构体定义，挂在同一SPI上的设备共享一个 */
+    typedef struct
+    {
+        void *id;                                              // 总线标识（设备的transport_ctx，例如SPI句柄）
+        AD840X_FrameTypeDef queue[AD840X_BUS_QUEUE_SIZE];        // 普通优先级帧存储
+        AD840X_FrameTypeDef urgent_queue[AD840X_BUS_URGENT_SIZE]; // 高优先级帧存储
+        AD840X_LaneTypeDef lane[AD840X_PRIORITY_COUNT];          // 各优先级的队列
+        volatile uint8_t active;                               // 正在发送的帧所在的优先级
+        volatile uint8_t busy;                                 // DMA传输进行中
+        volatile uint32_t errors;                              // 传输出错被丢弃的帧数
+        volatile uint32_t flushed;                             // 被高优先级写入取消的普通帧数
+        volatile uint32_t urgent_wait_max; // 高优先级帧从提交到开始发送期间完成的普通帧数（最大值）
+        volatile uint32_t frames;                              // 发送完成的帧数
+        volatile uint32_t waits;                               // 写入时普通队列已满、需要等待的次数
+        uint32_t busy_since;                                   // 本次连续发送开始时的AD840X_Time_Now()
+        uint64_t busy_cycles;                                  // DMA连续发送的累计计数周期
+#ifdef AD840X_USE_RTOS
+        void *os_mutex;  // 总线互斥量，见AD840X_OS.h
+        void *os_signal; // DMA完成信号量
+#endif
+    } AD840X_BusTypeDef;
+
+    /* 异步写的完成凭据 */
+    typedef struct
+    {
+        AD840X_BusTypeDef *bus;   // 帧所在总线，NULL表示已同步完成
+        uint32_t seq;             // 帧序号
+        HAL_StatusTypeDef status; // bus为NULL时的结果
+        uint8_t priority;         // 帧所在队列（AD840X_PriorityTypeDef）
+    } AD840X_TokenTypeDef;
+
+    /* 批量写命令 */
+    typedef struct
+    {
+        struct __AD840X_HandleTypeDef *hdev; // 目标设备
+        uint8_t channel;                     // 通道地址（AD840X_CHANNEL_x）
+        uint8_t value;                       // 8位电阻值（0-255）
+    } AD840X_CommandTypeDef;
+
+    /* 设备运行统计，用AD840X_GetStats读取一致的快照 */
+    typedef struct
+    {
+        uint32_t frames;      // 发出的帧数（含校验重试、SPI复位和恢复的帧）
+        uint32_t bytes;       // SPI移出的字节数（AD840X_Parallel每帧10个时钟，不计入）
+        uint32_t skipped;     // 与器件中的值相同而没有发送的写入（见AD840X_Config_SkipRedundant）
+        uint32_t waits;       // DMA队列已满、写入需要等待（紧急写入为被拒绝）的次数
+        uint32_t errors;      // 传输出错或校验最终失败的帧数
+        uint32_t retries;     // 回读校验的重试次数
+        uint32_t shutdown_ms; // 处于断电状态的累计时间（ms）
+    } AD840X_StatsTypeDef;
+
+    /* 总线运行统计，用AD840X_GetBusStats读取 */
+    typedef struct
+    {
+        uint32_t frames;          // 发送完成的帧数
+        uint32_t waits;           // 写入时普通队列已满、需要等待的次数
+        uint32_t errors;          // 传输出错被丢弃的帧数
+        uint32_t flushed;         // 被高优先级写入取消的普通帧数
+        uint32_t urgent_wait_max; // 高优先级帧前面最多插入的普通帧数
+        uint32_t busy_us;         // DMA连续发送的累计时间（μs），除以运行时间即总线占用率
+    } AD840X_BusStatsTypeDef;
+
+    /* 设备句柄结构体定义 */
+    typedef struct __AD840X_HandleTypeDef
+    {
+#ifdef HAL_SPI_MODULE_ENABLED
+        SPI_HandleTypeDef *hspi; // SPI句柄（HAL后端），其他后端为NULL
+#endif
+        AD840X_BusTypeDef *bus;  // 所在总线，DMA后端（或启用RTOS时所有后端）初始化时自动注册
+
+        const AD840X_TransportTypeDef *transport; // 传输后端
+        void *transport_ctx;                      // 传输后端私有数据
         GPIO_TypeDef *cs_port;   // CS端口 (必须)
         uint16_t cs_pin;         // CS引脚 (必须)
 
@@ -159,10 +367,40 @@ extern "C"
         uint16_t rs_pin;       // RS引脚 (可选)，PIN_NOT_CONNECTED表示未连接
 
         uint8_t use_dma; // 是否使用DMA传输
+
+        AD840X_ModelTypeDef model; // 器件型号
+        uint8_t num_channels;      // 实际通道数，批量操作只遍历这些通道
+
+        uint8_t verify;              // 是否启用SDO回读校验（仅AD8403）
+        uint8_t verify_max_retries;  // 校验失败时的最大重试次数
+        uint32_t verify_errors;      // 回读不一致的累计次数
+        uint32_t verify_retry_count; // 累计重试次数
+        uint16_t last_word;          // 上一次移入器件的10位数据字
+        uint8_t last_word_valid;     // last_word是否可作为比对基准
+
+        uint8_t mailbox[4];              // 各通道待发送的最新值（见AD840X_Queue.h）
+        volatile uint32_t mailbox_dirty; // 有新值待发送的通道位掩码（bit n对应通道n）
+
+        uint8_t shadow[4];   // 应用最后写入各通道的值，复位或掉电后用AD840X_Restore恢复
+        uint8_t shadow_valid; // shadow中有效的通道位掩码（bit n对应通道n）
+
+        uint32_t auto_shdn_ms;        // 自动断电的空闲时间（ms），0表示不自动断电
+        volatile uint32_t idle_since; // 最后一次写入（或唤醒）时的HAL_GetTick()
+        volatile uint8_t powered_down; // SHDN当前是否为断电状态
+        uint32_t wakeups;             // 写入时自动唤醒的次数
+
+        uint8_t deferred; // 推迟期间（MCU挂起前后）写入、等待补发的通道位掩码（bit n对应通道n）
+
+        uint8_t skip_redundant;   // 1-写入值与器件中已有的值相同时不发送
+        volatile uint32_t synced; // 器件中的值已等于shadow的通道位掩码，skip_redundant用
+        AD840X_StatsTypeDef stats; // 运行统计，中断和任务中直接累加，读取用AD840X_GetStats
+
+        uint8_t id; // 设备序号，按初始化顺序从0编号（ITM遥测用）
     } AD840X_HandleTypeDef;
 
     /* 函数声明 */
 
+#ifdef HAL_SPI_MODULE_ENABLED
     /**
      * @brief  初始化AD840X数字电位器
      * @param  hdev: AD840X设备句柄指针
@@ -174,6 +412,22 @@ extern "C"
      */
     void AD840X_Init(AD840X_HandleTypeDef *hdev, SPI_HandleTypeDef *hspi,
                      GPIO_TypeDef *cs_port, uint16_t cs_pin);
+#endif
+
+    /**
+     * @brief  使用指定的传输后端初始化AD840X数字电位器
+     * @param  hdev: AD840X设备句柄指针
+     * @param  transport: 传输后端操作表
+     * @param  transport_ctx: 传输后端私有数据（由后端解释）
+     * @param  cs_port: CS引脚端口
+     * @param  cs_pin: CS引脚
+     * @note   用于不经过HAL SPI的后端（例如AD840X_Parallel.h中的并行GPIO模拟SPI），
+     *         这类设备不使用DMA队列和回读校验
+     * @note   AD840X_POLICY为AD840X_POLICY_REG时只能传AD840X_Transport_Reg，否则调用Error_Handler
+     * @retval None
+     */
+    void AD840X_Init_Transport(AD840X_HandleTypeDef *hdev, const AD840X_TransportTypeDef *transport,
+                               void *transport_ctx, GPIO_TypeDef *cs_port, uint16_t cs_pin);
 
     /**
      * @brief  配置设备的SHDN和RS引脚（如果使用）
@@ -189,23 +443,182 @@ extern "C"
                             GPIO_TypeDef *shdn_port, uint16_t shdn_pin,
                             GPIO_TypeDef *rs_port, uint16_t rs_pin);
 
+    /**
+     * @brief  配置设备型号
+     * @param  hdev: AD840X设备句柄指针
+     * @param  model: 器件型号（AD840X_MODEL_AD8400/AD8402/AD8403）
+     * @note   未调用时默认按AD8403（4通道）处理，与旧版本行为一致
+     * @note   配置后复位等批量操作只访问实际存在的通道
+     * @retval None
+     */
+    void AD840X_Config_Model(AD840X_HandleTypeDef *hdev, AD840X_ModelTypeDef model);
+
+    /**
+     * @brief  配置回读校验写模式（仅AD8403）
+     * @param  hdev: AD840X设备句柄指针
+     * @param  enable: 1-启用，0-关闭
+     * @param  max_retries: 校验失败时的最大重试次数
+     * @note   需要SDO接到MISO并上拉4.7kΩ（Page22 Figure50），SPI必须是全双工
+     * @note   AD8403在移入新数据字的同时从SDO移出上一个数据字，比对不增加总线时间
+     * @note   启用后写操作使用阻塞的全双工传输，不再使用DMA；非AD8403、单线发送模式或GPIO模拟SPI没有配置SDO引脚时不会启用
+     * @retval None
+     */
+    void AD840X_Config_Verify(AD840X_HandleTypeDef *hdev, uint8_t enable, uint8_t max_retries);
+
     /**
      * @brief  AD840X写操作函数
      * @param  hdev: AD840X设备句柄指针
      * @param  channel: 通道地址（2位，见表13 Page22）
      * @param  value: 8位电阻值（0-255）
-     * @note   - 如果初始化时检测到SPI配置了DMA，将自动使用DMA方式传输
+     * @note   - 通道超出型号实际通道数时不发送任何数据
+     *         - 如果初始化时检测到SPI配置了DMA，将自动使用DMA方式传输：
+     *           帧进入总线队列后立即返回，队列满时等待；需要在HAL_SPI_TxCpltCallback中调用AD840X_SPI_TxCpltCallback
      *         - 数据格式：Page11 Table6（10位：2位地址+8位数据）
      *         - 时序图：Page10 Figure3/Figure4
      * @retval None
      */
     void AD840X_Write(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value);
 
+    /**
+     * @brief  异步写入，返回完成凭据
+     * @param  hdev: AD840X设备句柄指针
+     * @param  channel: 通道地址（AD840X_CHANNEL_x）
+     * @param  value: 8位电阻值（0-255）
+     * @param  callback: 完成回调，不需要时传NULL
+     * @param  arg: 回调参数
+     * @retval 完成凭据，用AD840X_Token_Poll查询或AD840X_Token_Wait等待
+     * @note   DMA后端：帧入队后立即返回，回调在发送完成中断中调用，回调里不要阻塞；
+     *         其他后端或回读校验模式：同步完成，返回前在调用者上下文中调用回调
+     * @note   DMA后端的Transmit_DMA启动失败（或帧已被AD840X_WriteUrgent取消）时，帧以HAL_ERROR结束，
+     *         回调在启动这一帧的上下文中调用：总线空闲时就是本函数的调用者，启用RTOS时此时还占有
+     *         总线互斥量。回调里不要获取自己的锁、也不要调用AD840X_Write等占有总线的函数，否则会死锁
+     * @note   通道超出型号实际通道数时不发送，结果为HAL_ERROR
+     */
+    AD840X_TokenTypeDef AD840X_WriteAsync(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value,
+                                          AD840X_CallbackTypeDef callback, void *arg);
+
+    /**
+     * @brief  高优先级写入，在下一个帧间隙插到所有普通帧之前发送
+     * @param  hdev: AD840X设备句柄指针
+     * @param  channel: 通道地址（AD840X_CHANNEL_x）
+     * @param  value: 8位电阻值（0-255）
+     * @param  flush: 1-同时取消队列中该设备该通道尚未发送的普通帧（它们以HAL_ERROR结束并计入bus->flushed），
+     *                避免紧急值被随后发出的旧值覆盖；0-不取消
+     * @param  callback: 完成回调，不需要时传NULL
+     * @param  arg: 回调参数
+     * @retval 完成凭据；高优先级队列已满时bus为NULL、status为HAL_ERROR
+     * @note   DMA后端：不占用总线互斥量，只在几十条指令的关中断临界区内入队，可在中断中调用。
+     *         最坏延迟 = 正在发送的1帧 + 已在高优先级队列中的帧 + 完成中断的处理时间，与普通队列长度无关；
+     *         bus->urgent_wait_max记录提交后、开始发送前完成的普通帧数，正常情况下不超过1
+     * @note   其他后端或回读校验模式：与AD840X_WriteAsync相同（没有队列可以插队），不能在中断中调用
+     * @note   只取消提交时已经入队的普通帧，之后写入的普通帧照常发送
+     */
+    AD840X_TokenTypeDef AD840X_WriteUrgent(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value, uint8_t flush,
+                                           AD840X_CallbackTypeDef callback, void *arg);
+
+    /**
+     * @brief  查询异步写的结果
+     * @param  token: 完成凭据
+     * @retval HAL_BUSY-未完成，HAL_OK-已锁存，HAL_ERROR-传输出错
+     * @note   帧完成后，同一优先级队列再完成队列长度（AD840X_BUS_QUEUE_SIZE/AD840X_BUS_URGENT_SIZE）帧以内
+     *         能查到出错状态，更早的帧只报告HAL_OK，需要可靠的错误状态时使用回调
+     */
+    HAL_StatusTypeDef AD840X_Token_Poll(const AD840X_TokenTypeDef *token);
+
+    /**
+     * @brief  等待异步写完成
+     * @param  token: 完成凭据
+     * @retval HAL_OK-已锁存，HAL_ERROR-传输出错
+     * @note   启用RTOS时阻塞在总线的完成信号量上，不要在中断或完成回调中调用
+     */
+    HAL_StatusTypeDef AD840X_Token_Wait(const AD840X_TokenTypeDef *token);
+
+#ifdef HAL_SPI_MODULE_ENABLED
+    /**
+     * @brief  获取SPI当前的SCK频率
+     * @param  hspi: SPI句柄指针
+     * @retval SCK频率（Hz）
+     */
+    uint32_t AD840X_SPI_GetClock(SPI_HandleTypeDef *hspi);
+
+    /**
+     * @brief  根据当前PCLK选择不超过上限的最快SPI分频系数
+     * @param  hspi: SPI句柄指针
+     * @param  max_hz: 允许的最高SCK频率，一般传AD840X_SPI_MAX_CLOCK_HZ
+     * @retval 实际的SCK频率（Hz）
+     * @note   例如72MHz的APB2上选择8分频（9MHz），而不是CubeMX默认的4分频（18MHz，超出手册规格）
+     * @note   时钟配置改变后需要重新调用
+     */
+    uint32_t AD840X_SPI_PlanClock(SPI_HandleTypeDef *hspi, uint32_t max_hz);
+
+    /**
+     * @brief  通过SDO回读探测超出手册规格的最高可用SPI时钟（仅AD8403）
+     * @param  hdev: AD840X设备句柄指针
+     * @param  channel: 探测时用于写入测试数据的通道
+     * @param  restore_value: 探测结束后写回该通道的值
+     * @retval 最终采用的SCK频率（Hz）
+     * @note   可选功能，需要SDO接到MISO；从当前分频逐级加快，回读出错即退回上一级
+     */
+    uint32_t AD840X_SPI_ProbeClock(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t restore_value);
+#endif
+
+    /**
+     * @brief  批量写入，多条SPI总线上的命令同时发送
+     * @param  cmds: 命令数组
+     * @param  count: 命令数量
+     * @note   设备分布在SPI1和SPI2上且都配置了DMA时，两条总线各自用DMA并行发送，
+     *         总吞吐接近单总线的两倍；同一设备的命令保持原有顺序
+     * @note   函数在所有命令发送完成后返回
+     * @retval None
+     */
+    void AD840X_WriteBatch(const AD840X_CommandTypeDef *cmds, uint16_t count);
+
+    /**
+     * @brief  等待设备所在总线上的DMA队列发送完毕
+     * @param  hdev: AD840X设备句柄指针
+     * @retval None
+     */
+    void AD840X_WaitIdle(AD840X_HandleTypeDef *hdev);
+
+    /**
+     * @brief  把各设备最后写入的值重新写回器件（RS复位、掉电重启后恢复状态）
+     * @param  devs: 设备句柄指针数组
+     * @param  count: 设备数量
+     * @param  from_midscale: 1-器件刚复位或上电，所有通道处于中值（Page12），跳过值为中值的通道；
+     *                        0-所有写过的通道都重发
+     * @param  frames: 返回实际发送的帧数，不需要时传NULL
+     * @note   每个写过的通道1帧，从未写过的通道不发送；所有帧先进入各总线的DMA队列，
+     *         多条总线并行发送，全部完成后返回
+     * @note   驱动在AD840X_Write/AD840X_WriteAsync/AD840X_WriteUrgent/AD840X_Parallel_Write时记录写入值，
+     *         AD840X_Reset不改变记录的值
+     * @retval 恢复耗时（μs），从第一帧入队到最后一帧锁存
+     */
+    uint32_t AD840X_Restore(AD840X_HandleTypeDef *const *devs, uint8_t count, uint8_t from_midscale,
+                            uint16_t *frames);
+
+#ifdef HAL_SPI_MODULE_ENABLED
+    /**
+     * @brief  SPI发送完成回调，DMA模式下必须调用
+     * @param  hspi: SPI句柄指针
+     * @note   在HAL_SPI_TxCpltCallback中调用，负责拉高CS并启动队列中的下一帧
+     * @retval None
+     */
+    void AD840X_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi);
+
+    /**
+     * @brief  SPI错误回调，DMA模式下建议调用
+     * @param  hspi: SPI句柄指针
+     * @note   在HAL_SPI_ErrorCallback中调用，丢弃出错的帧并继续发送队列
+     * @retval None
+     */
+    void AD840X_SPI_ErrorCallback(SPI_HandleTypeDef *hspi);
+#endif
+
     /**
      * @brief  通过RS引脚复位所有通道到中间值
      * @param  hdev: AD840X设备句柄指针
      * @note   时序需满足tRS≥50ns（Page10 Table4）
-     * @note   如果RS引脚未连接到STM32，此函数将通过SPI写入中间值
+     * @note   如果RS引脚未连接到STM32，此函数将通过SPI向型号实际存在的通道写入中间值
      * @ref    Page12 Pin Descriptions, Page20 Programming
      */
     void AD840X_Reset(AD840X_HandleTypeDef *hdev);
@@ -220,6 +633,78 @@ extern "C"
      */
     void AD840X_Shutdown(AD840X_HandleTypeDef *hdev, uint8_t state);
 
+    /**
+     * @brief  配置空闲自动断电
+     * @param  hdev: AD840X设备句柄指针
+     * @param  idle_ms: 距最后一次写入超过该时间后进入断电模式，0表示关闭
+     * @note   需要SHDN引脚接到STM32（AD8400没有SHDN引脚），否则不启用
+     * @note   断电后的下一次写入先拉高SHDN并等待ts（AD840X_T_SETTLE_NS），再发送数据，
+     *         写入报告完成时器件已稳定；手动AD840X_Shutdown(hdev, 0)断电的器件同样会被写入唤醒
+     * @retval None
+     */
+    void AD840X_Config_AutoShutdown(AD840X_HandleTypeDef *hdev, uint32_t idle_ms);
+
+    /**
+     * @brief  让空闲超时的器件进入断电模式
+     * @param  devs: 设备句柄指针数组
+     * @param  count: 设备数量
+     * @note   在主循环或周期任务中调用，检查间隔决定断电时刻的误差
+     * @retval 本次进入断电模式的器件数
+     */
+    uint8_t AD840X_AutoShutdown_Process(AD840X_HandleTypeDef *const *devs, uint8_t count);
+
+    /**
+     * @brief  写入前调用：刷新空闲计时，器件已自动断电时先唤醒
+     * @param  hdev: AD840X设备句柄指针
+     * @note   AD840X_Write等写入函数内部已调用，直接操作总线的后端（例如AD840X_Parallel）写入前需要调用
+     * @note   可在中断中调用；唤醒时忙等ts
+     * @retval None
+     */
+    void AD840X_AutoShutdown_Touch(AD840X_HandleTypeDef *hdev);
+
+    /**
+     * @brief  配置是否跳过重复写入
+     * @param  hdev: AD840X设备句柄指针
+     * @param  enable: 1-写入值与器件中已有的值相同时不发送（计入stats.skipped），0-每次都发送
+     * @note   只有确认已写入器件的值才作为比较基准：复位后、传输出错后该通道的下一次写入一定发送
+     * @retval None
+     */
+    void AD840X_Config_SkipRedundant(AD840X_HandleTypeDef *hdev, uint8_t enable);
+
+    /**
+     * @brief  读取设备运行统计
+     * @param  hdev: AD840X设备句柄指针
+     * @param  stats: 返回统计快照（关中断复制，各计数器相互一致）
+     * @note   shutdown_ms包含当前正在进行的断电时间
+     * @retval None
+     */
+    void AD840X_GetStats(AD840X_HandleTypeDef *hdev, AD840X_StatsTypeDef *stats);
+
+    /**
+     * @brief  读取设备所在总线的运行统计
+     * @param  hdev: AD840X设备句柄指针
+     * @param  stats: 返回统计快照
+     * @retval HAL_OK-成功，HAL_ERROR-设备没有注册总线（非DMA后端且未启用RTOS）
+     */
+    HAL_StatusTypeDef AD840X_GetBusStats(AD840X_HandleTypeDef *hdev, AD840X_BusStatsTypeDef *stats);
+
+    /**
+     * @brief  开始推迟写入：此后的写入只记录到shadow，不访问总线，并等待所有总线队列发送完毕
+     * @note   进入STOP模式前调用（见AD840X_Stop.h），唤醒中断里的写入会留到AD840X_Defer_End发送
+     * @note   不要在中断中调用
+     * @retval None
+     */
+    void AD840X_Defer_Begin(void);
+
+    /**
+     * @brief  结束推迟写入，发送推迟期间写入过的通道（每通道只发最后一次的值）
+     * @param  devs: 设备句柄指针数组
+     * @param  count: 设备数量
+     * @note   DMA总线上的帧入队后即返回，不等待发送完成
+     * @retval 补发的帧数
+     */
+    uint16_t AD840X_Defer_End(AD840X_HandleTypeDef *const *devs, uint8_t count);
+
     /**
      * @brief  计算8位控制值（0-255）对应的比例
      * @param  ratio: 所需比例（0.0~1.0对应0%~100%）
@@ -233,6 +718,7 @@ extern "C"
      * @param  hdev: AD840X设备句柄指针
      * @param  channel: 通道地址（AD840X_CHANNEL_x）
      * @param  ratio: 分压比例（0.0~1.0）
+     * @note   比例是常量时改用AD840X_Write(hdev, channel, AD840X_RATIO_CODE(ratio))
      * @retval 实际设置的分压比例值
      */
     float AD840X_WriteRatio(AD840X_HandleTypeDef *hdev, uint8_t channel, float ratio);
@@ -243,6 +729,8 @@ extern "C"
      * @param  channel: 通道地址（AD840X_CHANNEL_x）
      * @param  resistance: 目标电阻值（欧姆）
      * @param  full_scale: 设备满量程电阻值（欧姆）
+     * @note   参数是常量时改用AD840X_Write(hdev, channel, AD840X_RESISTANCE_CODE(resistance, full_scale))，
+     *         控制值在编译时算出，结果相同
      * @retval 实际设置的电阻值（欧姆）
      */
     float AD840X_WriteResistance(AD840X_HandleTypeDef *hdev, uint8_t channel,
@@ -0,0 +1,233 @@
+/*
+ * AD840X系列数字电位器驱动库 - C++模板驱动（只有头文件）
+ * 雪豹  编写   github.com/2827700630
+ *
+ * 器件型号、传输方式和CS引脚都作为模板参数，在编译时确定：
+ *    - 帧格式与AD840X_Write相同（Page11 Table6：2位地址+8位数据，16位帧，CS上升沿锁存）
+ *    - 通道号是模板参数，超出型号通道数的写入（例如AD8400写通道2）编译时报错
+ *    - CS引脚的端口和掩码都是常量，拉低/拉高各编译成一次BSRR写入，不经过函数指针
+ *    - 对象里只有各通道的shadow（AD8400为1字节，AD8403为4字节），没有句柄、指针和状态
+ * 只做阻塞写入，不使用DMA队列、回读校验、RTOS总线锁和统计；需要这些功能的设备继续用C接口
+ * （AD840X_HandleTypeDef），两种方式可以在同一工程中混用，但同一条SPI上不要同时有DMA在发送。
+ *
+ * 使用方法（C++源文件）：
+ *    #include "AD840X.hpp"
+ *
+ *    typedef AD840x_Pin<GPIOB_BASE, AD840X_CS1_Pin> Cs1; // 端口用GPIOx_BASE地址（AD840X_CS1_GPIO_Port为GPIOB）
+ *    AD840x<AD840X_MODEL_AD8403, AD840x_SpiReg<SPI1_BASE>, Cs1> pot1;
+ *    AD840x<AD840X_MODEL_AD8400, AD840x_SpiHal<&hspi1>, AD840x_Pin<GPIOB_BASE, AD840X_CS3_Pin> > pot3;
+ *
+ *    pot1.Write<AD840X_CHANNEL_3>(200);
+ *    pot1.Write<AD840X_CHANNEL_1>(AD840x_ResistanceCode(2500.0f, AD840X_10K_OHM)); // 编译时算出64
+ *    pot3.Write<AD840X_CHANNEL_2>(10); // 编译错误：AD8400只有通道1
+ *
+ * 传输方式是带静态成员函数Transmit(const uint8_t *data, uint16_t size)的类型，
+ * 需要其他外设或模拟SPI时按同样的形式自己定义即可。
+ */
+
+#ifndef __AD840X_HPP
+#define __AD840X_HPP
+
+#include "AD840X.h"
+#include "AD840X_Transport.h"
+
+/**
+ * @brief  换算结果四舍五入并钳制到0~255（与AD840X_CODE_ROUND相同）
+ * @param  x: 未取整的控制值
+ * @retval 8位控制值
+ */
+constexpr uint8_t AD840x_CodeRound(float x)
+{
+    return static_cast<uint8_t>(x <= 0.0f ? 0U : x >= 255.0f ? 255U : static_cast<uint32_t>(x + 0.5f));
+}
+
+/**
+ * @brief  分压比例换算为控制值，结果与AD840X_CalculateRatio相同
+ * @param  ratio: 分压比例（0.0~1.0）
+ * @retval 8位控制值
+ */
+constexpr uint8_t AD840x_RatioCode(float ratio)
+{
+    return AD840x_CodeRound(ratio * 255.0f);
+}
+
+/**
+ * @brief  电阻值换算为控制值，结果与AD840X_WriteResistance相同
+ * @param  resistance: 目标电阻值（欧姆）
+ * @param  full_scale: 设备满量程电阻值（欧姆）
+ * @retval 8位控制值
+ */
+constexpr uint8_t AD840x_ResistanceCode(float resistance, float full_scale)
+{
+    return AD840x_CodeRound(resistance / full_scale * 255.0f);
+}
+
+/**
+ * @brief  按RWB(D) = D / 256 × RAB + RW把W-B间电阻换算为控制值
+ * @param  resistance: 目标W-B间电阻值（欧姆）
+ * @param  full_scale: 标称电阻RAB（欧姆）
+ * @retval 8位控制值
+ */
+constexpr uint8_t AD840x_RwbCode(float resistance, float full_scale)
+{
+    return AD840x_CodeRound((resistance - AD840X_R_WIPER_OHM) * 256.0f / full_scale);
+}
+
+/**
+ * @brief  编译时确定的GPIO引脚
+ * @param  Port: GPIO端口基地址（GPIOx_BASE）
+ * @param  Mask: 引脚掩码（GPIO_PIN_x）
+ */
+template <uint32_t Port, uint16_t Mask>
+struct AD840x_Pin
+{
+    /**
+     * @brief  输出高电平（一次BSRR写入）
+     */
+    static inline void High()
+    {
+        reinterpret_cast<GPIO_TypeDef *>(Port)->BSRR = Mask;
+    }
+
+    /**
+     * @brief  输出低电平（一次BSRR写入，高16位为复位）
+     */
+    static inline void Low()
+    {
+        reinterpret_cast<GPIO_TypeDef *>(Port)->BSRR = static_cast<uint32_t>(Mask) << 16;
+    }
+};
+
+/**
+ * @brief  直接读写SPI寄存器的阻塞传输（与AD840X_Transport_Reg相同）
+ * @param  Base: SPI外设基地址（SPIx_BASE）
+ * @note   SPI仍由MX_SPIx_Init初始化，SCK分频可以先用AD840X_SPI_PlanClock规划
+ */
+template <uint32_t Base>
+struct AD840x_SpiReg
+{
+    /**
+     * @brief  阻塞发送，返回时最后一位已移出，可以拉高CS
+     * @param  data: 待发送数据
+     * @param  size: 字节数
+     */
+    static inline void Transmit(const uint8_t *data, uint16_t size)
+    {
+        AD840X_Reg_Send(reinterpret_cast<SPI_TypeDef *>(Base), data, size);
+    }
+};
+
+#ifdef HAL_SPI_MODULE_ENABLED
+/**
+ * @brief  HAL库阻塞传输（与AD840X_Transport_HAL相同）
+ * @param  Hspi: SPI句柄（全局变量的地址，例如&hspi1）
+ */
+template <SPI_HandleTypeDef *Hspi>
+struct AD840x_SpiHal
+{
+    /**
+     * @brief  阻塞发送
+     * @param  data: 待发送数据
+     * @param  size: 字节数
+     */
+    static inline void Transmit(const uint8_t *data, uint16_t size)
+    {
+        (void)HAL_SPI_Transmit(Hspi, const_cast<uint8_t *>(data), size, HAL_MAX_DELAY);
+    }
+};
+#endif
+
+/**
+ * @brief  AD840X数字电位器
+ * @param  Model: 器件型号（AD840X_MODEL_AD8400/AD8402/AD8403，枚举值即通道数）
+ * @param  Transport: 传输方式（AD840x_SpiReg、AD840x_SpiHal或自定义）
+ * @param  CsPin: CS引脚（AD840x_Pin）
+ * @note   SHDN、RS引脚没有接到单片机时必须外部上拉（见AD840X.h）
+ */
+template <AD840X_ModelTypeDef Model, class Transport, class CsPin>
+class AD840x
+{
+public:
+    /* 通道数 */
+    static const uint8_t channels = static_cast<uint8_t>(Model);
+
+    /**
+     * @brief  构造，shadow为上电后的中值（Page12），不访问硬件
+     */
+    AD840x()
+    {
+        for (uint8_t i = 0; i < channels; i++)
+        {
+            shadow_[i] = AD840X_MIDSCALE;
+        }
+    }
+
+    /**
+     * @brief  写一个通道
+     * @param  Channel: 通道地址（AD840X_CHANNEL_x），超出型号通道数时编译报错
+     * @param  value: 8位电阻值（0-255）
+     * @note   阻塞，返回时帧已锁存
+     */
+    template <uint8_t Channel>
+    void Write(uint8_t value)
+    {
+        static_assert(Channel < static_cast<uint8_t>(Model), "AD840x: 该型号没有这个通道（Page22 Table13）");
+        shadow_[Channel] = value;
+        Frame(Channel, value);
+    }
+
+    /**
+     * @brief  读取应用最后写入某通道的值
+     * @param  Channel: 通道地址（AD840X_CHANNEL_x），超出型号通道数时编译报错
+     * @retval 8位电阻值
+     */
+    template <uint8_t Channel>
+    uint8_t Get() const
+    {
+        static_assert(Channel < static_cast<uint8_t>(Model), "AD840x: 该型号没有这个通道（Page22 Table13）");
+        return shadow_[Channel];
+    }
+
+    /**
+     * @brief  用SPI把所有通道写为中值，效果与RS复位相同
+     * @note   与AD840X_Reset一样不改变shadow，之后可以用Restore恢复
+     */
+    void Reset()
+    {
+        for (uint8_t i = 0; i < channels; i++)
+        {
+            Frame(i, AD840X_MIDSCALE);
+        }
+    }
+
+    /**
+     * @brief  把shadow中的值重新写入所有通道（RS复位或掉电之后）
+     * @note   与AD840X_Restore不同，不区分是否写过，每个通道都发送
+     */
+    void Restore()
+    {
+        for (uint8_t i = 0; i < channels; i++)
+        {
+            Frame(i, shadow_[i]);
+        }
+    }
+
+private:
+    uint8_t shadow_[static_cast<uint8_t>(Model)]; // 各通道最后写入的值
+
+    /**
+     * @brief  发送一帧（channel由调用者保证有效）
+     * @param  channel: 通道地址
+     * @param  value: 8位电阻值
+     */
+    inline void Frame(uint8_t channel, uint8_t value)
+    {
+        const uint8_t tx[2] = {channel, value}; // 地址位在Bit9-Bit8，数据位在Bit7-Bit0（Table6 Page11）
+
+        CsPin::Low(); // CS拉低（满足tCSS >10ns，Page10 Table4）
+        Transport::Transmit(tx, 2);
+        CsPin::High(); // CS上升沿锁存
+    }
+};
+
+#endif /* __AD840X_HPP */
@@ -0,0 +1,129 @@
+/*
+ * AD840X系列数字电位器驱动库 - 原子操作
+ * 雪豹  编写   github.com/2827700630
+ *
+ * 无锁队列用到的32位原子操作，不关中断：
+ *    Cortex-M3/M4：LDREX/STREX独占访问，期间被中断打断时STREX失败并重试
+ *    其他平台（Linux仿真）：GCC的__atomic内建函数
+ */
+
+#ifndef __AD840X_ATOMIC_H
+#define __AD840X_ATOMIC_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "main.h"
+
+    /**
+     * @brief  比较并交换
+     * @param  ptr: 目标地址
+     * @param  expected: 期望的旧值
+     * @param  desired: 新值
+     * @retval 1-*ptr等于expected并已写入desired，0-*ptr已被修改，未写入
+     */
+    static inline uint8_t AD840X_Atomic_CAS(volatile uint32_t *ptr, uint32_t expected, uint32_t desired)
+    {
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+        do
+        {
+            if (__LDREXW(ptr) != expected)
+            {
+                __CLREX();
+                return 0;
+            }
+        } while (__STREXW(desired, ptr) != 0U); // 独占访问被打断，重试
+        return 1;
+#else
+        return __atomic_compare_exchange_n(ptr, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED) ? 1U : 0U;
+#endif
+    }
+
+    /**
+     * @brief  原子加
+     * @param  ptr: 目标地址
+     * @param  value: 加数
+     * @retval 加之前的值
+     */
+    static inline uint32_t AD840X_Atomic_FetchAdd(volatile uint32_t *ptr, uint32_t value)
+    {
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+        uint32_t old;
+
+        do
+        {
+            old = __LDREXW(ptr);
+        } while (__STREXW(old + value, ptr) != 0U);
+        return old;
+#else
+        return __atomic_fetch_add(ptr, value, __ATOMIC_ACQ_REL);
+#endif
+    }
+
+    /**
+     * @brief  原子按位或
+     * @param  ptr: 目标地址
+     * @param  mask: 要置1的位
+     * @retval None
+     */
+    static inline void AD840X_Atomic_Or(volatile uint32_t *ptr, uint32_t mask)
+    {
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+        uint32_t old;
+
+        do
+        {
+            old = __LDREXW(ptr);
+        } while (__STREXW(old | mask, ptr) != 0U);
+#else
+        __atomic_fetch_or(ptr, mask, __ATOMIC_ACQ_REL);
+#endif
+    }
+
+    /**
+     * @brief  原子按位与
+     * @param  ptr: 目标地址
+     * @param  mask: 要保留的位
+     * @retval None
+     */
+    static inline void AD840X_Atomic_And(volatile uint32_t *ptr, uint32_t mask)
+    {
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+        uint32_t old;
+
+        do
+        {
+            old = __LDREXW(ptr);
+        } while (__STREXW(old & mask, ptr) != 0U);
+#else
+        __atomic_fetch_and(ptr, mask, __ATOMIC_ACQ_REL);
+#endif
+    }
+
+    /**
+     * @brief  原子交换
+     * @param  ptr: 目标地址
+     * @param  value: 新值
+     * @retval 交换前的值
+     */
+    static inline uint32_t AD840X_Atomic_Exchange(volatile uint32_t *ptr, uint32_t value)
+    {
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+        uint32_t old;
+
+        do
+        {
+            old = __LDREXW(ptr);
+        } while (__STREXW(value, ptr) != 0U);
+        return old;
+#else
+        return __atomic_exchange_n(ptr, value, __ATOMIC_ACQ_REL);
+#endif
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __AD840X_ATOMIC_H */
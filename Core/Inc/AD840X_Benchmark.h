@@ -0,0 +1,54 @@
+/*
+ * AD840X系列数字电位器驱动库 - 板上基准测试
+ * 雪豹  编写   github.com/2827700630
+ *
+ * 固定的场景矩阵，每个场景写入AD840X_BENCHMARK_WRITES次，用DWT周期计数器计时：
+ *    - 传输后端：HAL阻塞、寄存器直接访问、LL阻塞、GPIO模拟SPI（借用PA5/PA7）、LL DMA（DMA1 Channel3）
+ *    - 每批帧数：1、4、16（AD840X_WriteBatch，每批结束时等待DMA发完）
+ *    - 设备数：1、2、3（CS1-CS3轮流写）
+ * 每个场景输出一行CSV：backend,devices,batch,writes,cycles_per_write,writes_per_s，
+ * 每块板子（每个硬件版本）跑一次保存结果，前后对比即可发现吞吐量下降。
+ * 固定写入路径（AD840X_POLICY，见AD840X.h）时只运行该路径支持的后端：BLOCKING为hal、reg、ll、bitbang，
+ * REG为reg，DMA为ll_dma；第一行注释中输出编译时的写入路径，env:benchmark_blocking等环境用于对比。
+ *
+ * 在platformio.ini中选择env:benchmark编译（定义了AD840X_BENCHMARK），main()初始化外设后
+ * 调用AD840X_Benchmark_Run，跑完后停住。结果默认从ITM端口0（SWO，PB3）输出，
+ * 定义AD840X_BENCHMARK_SEMIHOSTING时改用半主机输出（必须连着调试器运行，否则断点指令会进入HardFault），
+ * 也可以定义AD840X_BENCHMARK_PUTS(line)换成串口等其他输出。
+ *
+ * 注意：
+ *    - 本工程CubeMX没有给SPI1配置DMA，HAL DMA后端不在矩阵中；LL DMA场景在这里自己打开DMA1时钟和中断，
+ *      并定义了DMA1_Channel3_IRQHandler，CubeMX中给SPI1_TX加了DMA后要去掉这个场景
+ *    - SCK按AD840X_SPI_MAX_CLOCK_HZ规划（72MHz下为9MHz），各后端相同
+ *    - 跑完后SPI1保持LL DMA的配置（TXDMAEN），不要在基准测试之后继续使用HAL后端
+ *    - 本文件只在x86 gcc下对照F1的HAL/LL头文件做过语法检查，还没有用arm-none-eabi-gcc编译、也没有在板上
+ *      运行过（半主机的内联汇编、DMA1_Channel3_IRQHandler、PA5/PA7的切换都未经实测）。第一次使用时确认
+ *      pio run -e benchmark编译通过，输出一行"# AD840X benchmark"表头、一行CSV列名和45行数据后以"# done"结束
+ */
+
+#ifndef __AD840X_BENCHMARK_H
+#define __AD840X_BENCHMARK_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "AD840X.h"
+
+/* 每个场景的写入次数，必须是16的倍数 */
+#ifndef AD840X_BENCHMARK_WRITES
+#define AD840X_BENCHMARK_WRITES 1024
+#endif
+
+    /**
+     * @brief  依次运行所有基准测试场景并输出结果
+     * @note   在MX_GPIO_Init、MX_SPI1_Init之后调用，会重新初始化所用的设备句柄
+     * @retval None
+     */
+    void AD840X_Benchmark_Run(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __AD840X_BENCHMARK_H */
@@ -0,0 +1,68 @@
+/*
+ * AD840X系列数字电位器驱动库 - SWO/ITM实时遥测
+ * 雪豹  编写   github.com/2827700630
+ *
+ * 每次通道值锁存（CS上升沿、RS复位）后，向专用的ITM激励端口写一个32位数据包，
+ * 调试器通过SWO引脚（PB3）接收，不占用串口。主机上用Tools/ad840x_itm_decode.py把SWO数据流转成CSV，
+ * 可以实时画出所有通道的曲线。
+ *
+ * 数据包（小端32位，一次写入，多个中断同时发送也不会交错）：
+ *    bit7-0    通道值
+ *    bit9-8    通道地址
+ *    bit15-10  设备序号（hdev->id，按初始化顺序从0编号）
+ *    bit31-16  时间戳：AD840X_Time_Now() >> AD840X_ITM_TS_SHIFT 的低16位
+ * 发送不等待：ITM的FIFO满时丢弃该包并计数（AD840X_ITM_Dropped），写入路径不会被SWO速率拖慢；
+ * 调试器没有打开ITM或该端口时直接返回。
+ *
+ * 在编译选项中定义AD840X_USE_ITM启用。还需要：
+ *    - CubeMX的SYS -> Debug选择Trace Asynchronous Sw（PB3作SWO）
+ *    - 调试器打开SWO并使能激励端口AD840X_ITM_PORT（见README）
+ */
+
+#ifndef __AD840X_ITM_H
+#define __AD840X_ITM_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "AD840X.h"
+
+/* 激励端口号（0-31），端口0一般留给printf重定向 */
+#ifndef AD840X_ITM_PORT
+#define AD840X_ITM_PORT 8
+#endif
+
+/* 时间戳右移位数：72MHz下每单位约14.2μs，16位约0.93秒回绕一次 */
+#ifndef AD840X_ITM_TS_SHIFT
+#define AD840X_ITM_TS_SHIFT 10
+#endif
+
+/* ITM访问，其他平台（Linux仿真）在包含本文件之前定义这三个宏即可替换 */
+#ifndef AD840X_ITM_WRITE
+#define AD840X_ITM_ENABLED(port) ((ITM->TCR & ITM_TCR_ITMENA_Msk) && (ITM->TER & (1UL << (port))))
+#define AD840X_ITM_FIFO_READY(port) (ITM->PORT[port].u32 != 0UL)
+#define AD840X_ITM_WRITE(port, word) (ITM->PORT[port].u32 = (word))
+#endif
+
+    /**
+     * @brief  发送一个通道值数据包
+     * @param  hdev: AD840X设备句柄指针
+     * @param  channel: 通道地址
+     * @param  value: 锁存的通道值
+     * @note   驱动在值锁存后调用（包括DMA完成中断），可在中断中调用
+     * @retval None
+     */
+    void AD840X_ITM_Send(const AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value);
+
+    /**
+     * @brief  读取FIFO满而丢弃的数据包数
+     * @retval 丢弃数
+     */
+    uint32_t AD840X_ITM_Dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __AD840X_ITM_H */
@@ -0,0 +1,75 @@
+/*
+ * AD840X系列数字电位器驱动库 - RTOS集成层
+ * 雪豹  编写   github.com/2827700630
+ *
+ * 多个任务对挂在同一SPI上的设备调用AD840X_Write时，各自的CS帧可能交错，
+ * DMA队列的写入端也会被同时修改。定义AD840X_USE_RTOS后：
+ *    - 每条总线一个互斥量，AD840X_Write/AD840X_WaitIdle在整帧（或入队）期间持有
+ *    - 等待DMA队列腾出空间或发送完毕时阻塞在总线的信号量上，不再空转
+ *    - DMA完成中断不加锁：队列仍是单生产者/单消费者环形缓冲，中断只释放信号量
+ *
+ * 使用方法（FreeRTOS）：
+ *    1. 在编译选项中定义AD840X_USE_RTOS（例如platformio.ini的build_flags加-DAD840X_USE_RTOS）
+ *    2. 工程中加入FreeRTOS，AD840X_OS_FreeRTOS.c提供本文件中的接口
+ *    3. 所有设备在启动调度器之前初始化；同一SPI上的设备共用一个transport_ctx，
+ *       启用RTOS后每个transport_ctx都会注册一条总线，AD840X_MAX_BUSES要不小于它们的数量
+ *    4. DMA（或SPI）中断的优先级数值不能小于configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY，
+ *       否则不能在中断中释放信号量
+ * 调度器启动前这些接口退化为空转等待，初始化阶段的写入不受影响。
+ * 其他RTOS按本文件的接口另写一个实现即可，Linux仿真中的pthread实现见Sim/AD840X_OS_Pthread.c。
+ *
+ * 注意：AD840X_SPI_PlanClock、AD840X_SPI_ProbeClock不加锁，多任务使用时由调用者保证互斥。
+ */
+
+#ifndef __AD840X_OS_H
+#define __AD840X_OS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "AD840X.h"
+
+    /**
+     * @brief  为新注册的总线创建互斥量和完成信号量
+     * @param  bus: 总线指针
+     * @note   在总线注册时调用（设备初始化阶段），失败时应调用Error_Handler
+     * @retval None
+     */
+    void AD840X_OS_BusInit(AD840X_BusTypeDef *bus);
+
+    /**
+     * @brief  占有总线，其他任务在此阻塞
+     * @param  bus: 总线指针
+     * @retval None
+     */
+    void AD840X_OS_BusLock(AD840X_BusTypeDef *bus);
+
+    /**
+     * @brief  释放总线
+     * @param  bus: 总线指针
+     * @retval None
+     */
+    void AD840X_OS_BusUnlock(AD840X_BusTypeDef *bus);
+
+    /**
+     * @brief  阻塞等待总线的DMA完成通知
+     * @param  bus: 总线指针
+     * @note   调用者持有总线互斥量，醒来后重新检查等待条件；允许提前返回
+     * @retval None
+     */
+    void AD840X_OS_BusWait(AD840X_BusTypeDef *bus);
+
+    /**
+     * @brief  在DMA完成中断中通知等待的任务
+     * @param  bus: 总线指针
+     * @note   只能使用中断安全的接口，不能阻塞
+     * @retval None
+     */
+    void AD840X_OS_BusSignalFromISR(AD840X_BusTypeDef *bus);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __AD840X_OS_H */
@@ -0,0 +1,108 @@
+/*
+ * AD840X系列数字电位器驱动库 - 多通道并行GPIO模拟SPI后端
+ * 雪豹  编写   github.com/2827700630
+ *
+ * 所有器件共用一根SCK，每个器件的SDI接到同一GPIO端口的不同引脚上。
+ * 每个时钟周期只需一次BSRR写入，就能同时向最多16个器件各移入1位，
+ * 因此16个器件的更新时间与1帧相同。
+ *
+ * 接线：
+ *    SCK       -> 任意GPIO，所有器件共用
+ *    SDIx      -> sdi_port上的引脚，每个器件一根
+ *    CSx       -> cs_port上的引脚，每个器件一根（同一端口才能一次写入同时拉低）
+ *    所有引脚在CubeMX中配置为Output Push-Pull，速度High
+ *
+ * 时序：数据在SCK上升沿前写入（tDS），SCK高/低电平各插入AD840X_PARALLEL_DELAY()，
+ * 72MHz下默认延时保证SCK不超过10MHz（Page1 Features, Page10 Table4）
+ */
+
+#ifndef __AD840X_PARALLEL_H
+#define __AD840X_PARALLEL_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "AD840X.h"
+
+/* 一个GPIO端口最多16根SDI */
+#define AD840X_PARALLEL_MAX_LANES 16
+
+/* SCK半周期延时，主频更高时需要加长 */
+#ifndef AD840X_PARALLEL_DELAY
+#define AD840X_PARALLEL_DELAY() \
+    do                          \
+    {                           \
+        __NOP();                \
+        __NOP();                \
+    } while (0)
+#endif
+
+    struct __AD840X_ParallelTypeDef;
+
+    /* 并行通道（每个器件一条） */
+    typedef struct
+    {
+        struct __AD840X_ParallelTypeDef *group; // 所属并行组
+        AD840X_HandleTypeDef *hdev;             // 该通道上的器件
+        uint16_t sdi_pin;                       // SDI引脚（sdi_port上）
+        uint16_t cs_pin;                        // CS引脚（cs_port上）
+    } AD840X_ParallelLaneTypeDef;
+
+    /* 并行组，共用SCK的一组器件 */
+    typedef struct __AD840X_ParallelTypeDef
+    {
+        GPIO_TypeDef *sdi_port; // 所有SDI所在端口
+        GPIO_TypeDef *sck_port; // SCK端口
+        uint16_t sck_pin;       // SCK引脚
+        GPIO_TypeDef *cs_port;  // 所有CS所在端口
+
+        AD840X_ParallelLaneTypeDef lanes[AD840X_PARALLEL_MAX_LANES];
+        uint8_t num_lanes; // 已添加的通道数
+    } AD840X_ParallelTypeDef;
+
+    /* 并行GPIO后端的单器件传输，transport_ctx为所属的AD840X_ParallelTypeDef指针（组内器件共用一条总线） */
+    extern const AD840X_TransportTypeDef AD840X_Transport_Parallel;
+
+    /**
+     * @brief  初始化并行组
+     * @param  group: 并行组指针
+     * @param  sdi_port: 所有SDI引脚所在端口
+     * @param  sck_port: SCK端口
+     * @param  sck_pin: SCK引脚
+     * @param  cs_port: 所有CS引脚所在端口
+     * @retval None
+     */
+    void AD840X_Parallel_Init(AD840X_ParallelTypeDef *group, GPIO_TypeDef *sdi_port,
+                              GPIO_TypeDef *sck_port, uint16_t sck_pin, GPIO_TypeDef *cs_port);
+
+    /**
+     * @brief  向并行组添加一个器件并初始化它的设备句柄
+     * @param  group: 并行组指针
+     * @param  hdev: AD840X设备句柄指针
+     * @param  sdi_pin: 该器件的SDI引脚（sdi_port上）
+     * @param  cs_pin: 该器件的CS引脚（cs_port上）
+     * @retval 通道编号（0~15），组已满时返回0xFF
+     * @note   添加后hdev可以像普通设备一样使用AD840X_Write等函数
+     */
+    uint8_t AD840X_Parallel_AddLane(AD840X_ParallelTypeDef *group, AD840X_HandleTypeDef *hdev,
+                                    uint16_t sdi_pin, uint16_t cs_pin);
+
+    /**
+     * @brief  在一帧时间内同时更新多个器件
+     * @param  group: 并行组指针
+     * @param  lanes: 参与本次更新的通道位掩码（bit n对应通道n）
+     * @param  channels: 每个通道要写的电位器通道地址（AD840X_CHANNEL_x），按通道编号索引
+     * @param  values: 每个通道要写的8位电阻值，按通道编号索引
+     * @note   电位器通道超出该器件型号的通道数时，该器件不参与本次更新；跳过重复值、推迟写入、
+     *         RTOS总线锁、统计和跟踪与AD840X_Write相同，被跳过或推迟的器件也不参与本次更新
+     * @retval None
+     */
+    void AD840X_Parallel_Write(AD840X_ParallelTypeDef *group, uint16_t lanes,
+                               const uint8_t *channels, const uint8_t *values);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __AD840X_PARALLEL_H */
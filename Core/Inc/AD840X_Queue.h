@@ -0,0 +1,108 @@
+/*
+ * AD840X系列数字电位器驱动库 - 多生产者命令队列
+ * 雪豹  编写   github.com/2827700630
+ *
+ * 定时器中断、外部中断和主循环都可以提交电位器更新命令，由总线工作者（主循环或一个任务）
+ * 统一取出并调用AD840X_Write发送。
+ *    - 多生产者、单消费者，容量固定（AD840X_QUEUE_SIZE）
+ *    - 生产者无锁：用LDREX/STREX抢占一个槽位（见AD840X_Atomic.h），不关中断、不阻塞，
+ *      队列满时立即返回失败并计数
+ *    - 每个槽位带序号，生产者写完数据后才发布序号，消费者只取已发布的槽位
+ * 同一生产者提交的命令按顺序发送；不同生产者之间按抢到槽位的先后顺序。
+ *
+ * 生产者比总线快时（例如编码器、PID输出），FIFO里积压的都是过时的值，延迟越来越大。
+ * 这时改用每通道一个槽位的邮箱（AD840X_Mailbox_Post）：
+ *    - 生产者直接覆盖该通道的槽位并置脏位，同样无锁、可在中断中调用
+ *    - 工作者每次只发送每个脏通道的最新值，中间值被丢弃
+ *    - 内存固定（每个设备4字节+1个脏位掩码），最坏延迟是一轮脏通道的发送时间，与提交频率无关
+ *
+ * 使用方法：
+ *    AD840X_QueueTypeDef ad840x_queue;
+ *    AD840X_Queue_Init(&ad840x_queue);
+ *    // 任意中断或任务中
+ *    AD840X_Queue_Push(&ad840x_queue, &hAD840X_1, AD840X_CHANNEL_1, value);
+ *    // 主循环或总线工作任务中
+ *    AD840X_Queue_Process(&ad840x_queue);
+ */
+
+#ifndef __AD840X_QUEUE_H
+#define __AD840X_QUEUE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "AD840X.h"
+
+/* 命令队列容量，必须是2的幂 */
+#ifndef AD840X_QUEUE_SIZE
+#define AD840X_QUEUE_SIZE 32
+#endif
+
+    /* 队列槽位 */
+    typedef struct
+    {
+        volatile uint32_t seq;     // 发布序号：写入位置+1表示数据已就绪
+        AD840X_CommandTypeDef cmd; // 命令
+    } AD840X_QueueSlotTypeDef;
+
+    /* 多生产者命令队列 */
+    typedef struct
+    {
+        AD840X_QueueSlotTypeDef slots[AD840X_QUEUE_SIZE];
+        volatile uint32_t head;    // 下一个写入位置（生产者原子修改）
+        volatile uint32_t tail;    // 下一个读出位置（只由消费者修改）
+        volatile uint32_t dropped; // 队列满被丢弃的命令数
+    } AD840X_QueueTypeDef;
+
+    /**
+     * @brief  初始化命令队列
+     * @param  queue: 队列指针
+     * @retval None
+     */
+    void AD840X_Queue_Init(AD840X_QueueTypeDef *queue);
+
+    /**
+     * @brief  提交一条命令，可在中断中调用
+     * @param  queue: 队列指针
+     * @param  hdev: AD840X设备句柄指针
+     * @param  channel: 通道地址（AD840X_CHANNEL_x）
+     * @param  value: 8位电阻值（0-255）
+     * @retval 1-成功，0-队列已满（命令被丢弃，dropped加1）
+     */
+    uint8_t AD840X_Queue_Push(AD840X_QueueTypeDef *queue, AD840X_HandleTypeDef *hdev, uint8_t channel,
+                              uint8_t value);
+
+    /**
+     * @brief  取出队列中所有已就绪的命令并发送
+     * @param  queue: 队列指针
+     * @note   只能在一个执行流（主循环或总线工作任务）中调用，不要在中断中调用
+     * @note   遇到已被抢占但还没写完的槽位时停止，剩余命令留到下一次
+     * @retval 本次发送的命令数
+     */
+    uint16_t AD840X_Queue_Process(AD840X_QueueTypeDef *queue);
+
+    /**
+     * @brief  把通道的新值放入邮箱，覆盖尚未发送的旧值，可在中断中调用
+     * @param  hdev: AD840X设备句柄指针
+     * @param  channel: 通道地址（AD840X_CHANNEL_x）
+     * @param  value: 8位电阻值（0-255）
+     * @retval None
+     */
+    void AD840X_Mailbox_Post(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value);
+
+    /**
+     * @brief  发送各设备邮箱中所有脏通道的最新值
+     * @param  devs: 设备句柄指针数组
+     * @param  count: 设备数量
+     * @note   只能在一个执行流（主循环或总线工作任务）中调用，不要在中断中调用
+     * @note   取走脏位后才读槽位，期间被覆盖的值会在下一轮再次发送，最新值不会丢失
+     * @retval 本次发送的帧数
+     */
+    uint16_t AD840X_Mailbox_Process(AD840X_HandleTypeDef *const *devs, uint8_t count);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __AD840X_QUEUE_H */
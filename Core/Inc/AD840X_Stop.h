@@ -0,0 +1,76 @@
+/*
+ * AD840X系列数字电位器驱动库 - STOP模式挂起/恢复
+ * 雪豹  编写   github.com/2827700630
+ *
+ * 两次更新之间让STM32F103进入STOP模式时使用：
+ *    进入STOP前  AD840X_Suspend：等总线队列发完，保存SPI和DMA通道的配置寄存器（每条总线16字节），
+ *                之后的写入（包括唤醒中断里的写入）只记录，不访问总线
+ *    唤醒后      AD840X_Resume：寄存器被改动过时直接写回（不走HAL_SPI_Init/HAL_DMA_Init），
+ *                再补发挂起期间写入的通道
+ *
+ * STOP模式下外设寄存器内容保持，唤醒后时钟切换到HSI（8MHz），PLL要由SystemClock_Config重新打开。
+ * SPI分频系数不变，HSI下SCK只会更慢，不超过10MHz上限（Page1 Features），
+ * 因此AD840X_Resume可以在SystemClock_Config之前调用，第一帧不必等待HSE起振和PLL锁定。
+ * HSI下SystemCoreClock仍是原来的值，AD840X_Time的延时只会偏长，不会短于时序要求。
+ *
+ * 不要在STOP前调用HAL_SPI_DeInit：HAL句柄的状态会变为RESET，只写回寄存器不能恢复。
+ * AD840X_Parallel_Write与AD840X_Write相同，挂起期间只记录，由AD840X_Resume（AD840X_Defer_End）
+ * 逐个器件补发，devs中要包含并行组里的器件；补发的帧不再同时锁存。
+ */
+
+#ifndef __AD840X_STOP_H
+#define __AD840X_STOP_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "AD840X.h"
+
+    /* 一条SPI总线的挂起现场 */
+    typedef struct
+    {
+        SPI_TypeDef *spi;         // SPI外设（SPI1/SPI2）
+        DMA_Channel_TypeDef *dma; // TX方向的DMA通道（例如DMA1_Channel3），不使用DMA时为NULL
+        uint16_t cr1;             // 挂起时的SPI_CR1
+        uint16_t cr2;             // 挂起时的SPI_CR2
+        uint32_t ccr;             // 挂起时的DMA_CCRx（不含EN位）
+        uint32_t cpar;            // 挂起时的DMA_CPARx
+        uint32_t reloads;         // 唤醒后发现寄存器被改动、重新写入的次数
+    } AD840X_StopTypeDef;
+
+    /**
+     * @brief  初始化一条总线的挂起现场
+     * @param  ctx: 挂起现场指针
+     * @param  spi: SPI外设（SPI1/SPI2）
+     * @param  dma: TX方向的DMA通道（SPI1_TX为DMA1_Channel3，SPI2_TX为DMA1_Channel5），不使用DMA时传NULL
+     * @retval None
+     */
+    void AD840X_Stop_Init(AD840X_StopTypeDef *ctx, SPI_TypeDef *spi, DMA_Channel_TypeDef *dma);
+
+    /**
+     * @brief  进入STOP模式前调用：等待总线空闲，保存SPI/DMA配置，开始推迟写入
+     * @param  ctx: 挂起现场数组，每条SPI总线一个
+     * @param  count: 数组长度
+     * @note   不要在中断中调用
+     * @retval None
+     */
+    void AD840X_Suspend(AD840X_StopTypeDef *ctx, uint8_t count);
+
+    /**
+     * @brief  唤醒后调用：写回被改动的SPI/DMA配置，补发挂起期间写入的通道
+     * @param  ctx: 挂起现场数组，与AD840X_Suspend相同
+     * @param  count: 数组长度
+     * @param  devs: 设备句柄指针数组
+     * @param  dev_count: 设备数量
+     * @note   可以在SystemClock_Config之前调用；DMA总线上的帧入队后即返回
+     * @retval 补发的帧数
+     */
+    uint16_t AD840X_Resume(AD840X_StopTypeDef *ctx, uint8_t count,
+                           AD840X_HandleTypeDef *const *devs, uint8_t dev_count);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __AD840X_STOP_H */
@@ -0,0 +1,116 @@
+/*
+ * AD840X系列数字电位器驱动库 - 微秒级计时
+ * 雪豹  编写   github.com/2827700630
+ *
+ * 用DWT周期计数器（CYCCNT）实现纳秒/微秒级延时和非阻塞超时，替代HAL_Delay(1)和按经验估算的空循环：
+ *    - 按实际主频换算，任何时钟配置下都保证至少等待指定时间
+ *    - AD840X_Time_DelayNs/Us阻塞等待，AD840X_Deadline_xxx用于主循环中的非阻塞等待
+ *    - AD840X_Time_Now/AD840X_Time_ToUs可用于测量一段操作的耗时
+ * 计数器72MHz时约59秒回绕一次，单次延时和超时不超过AD840X_TIME_MAX_NS。
+ *
+ * 时间来源由AD840X_TIME_NOW()决定，默认读DWT->CYCCNT；其他平台（Linux仿真、没有DWT的Cortex-M0）
+ * 在包含本文件之前定义AD840X_TIME_NOW()和AD840X_TIME_HZ即可替换。
+ */
+
+#ifndef __AD840X_TIME_H
+#define __AD840X_TIME_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "main.h"
+
+/* 时间来源：返回32位自由运行的周期计数 */
+#ifndef AD840X_TIME_NOW
+#define AD840X_TIME_USE_DWT
+#define AD840X_TIME_NOW() (DWT->CYCCNT)
+#endif
+
+/* 计数频率（Hz） */
+#ifndef AD840X_TIME_HZ
+#define AD840X_TIME_HZ SystemCoreClock
+#endif
+
+/* 单次延时/超时的上限（ns），保证72MHz下计数器不回绕 */
+#define AD840X_TIME_MAX_NS 4000000000UL
+
+    /* 非阻塞超时 */
+    typedef struct
+    {
+        uint32_t start;  // 开始时的计数值
+        uint32_t cycles; // 超时的计数周期数
+    } AD840X_DeadlineTypeDef;
+
+    /**
+     * @brief  初始化计时（打开DWT周期计数器）
+     * @note   AD840X_Init/AD840X_Init_Transport中已调用；不清零CYCCNT，不影响其他使用者
+     * @retval None
+     */
+    void AD840X_Time_Init(void);
+
+    /**
+     * @brief  纳秒换算为计数周期数，向上取整
+     * @param  ns: 纳秒
+     * @retval 计数周期数
+     */
+    uint32_t AD840X_Time_Cycles(uint32_t ns);
+
+    /**
+     * @brief  阻塞延时至少ns纳秒
+     * @param  ns: 纳秒（不超过AD840X_TIME_MAX_NS）
+     * @note   可在中断中调用；极短的延时（几十纳秒）实际由函数调用开销决定
+     * @retval None
+     */
+    void AD840X_Time_DelayNs(uint32_t ns);
+
+    /**
+     * @brief  阻塞延时至少us微秒
+     * @param  us: 微秒
+     * @retval None
+     */
+    void AD840X_Time_DelayUs(uint32_t us);
+
+    /**
+     * @brief  计数周期数换算为微秒
+     * @param  cycles: 计数周期数（两次AD840X_Time_Now之差）
+     * @retval 微秒
+     */
+    uint32_t AD840X_Time_ToUs(uint32_t cycles);
+
+    /**
+     * @brief  读当前计数值
+     * @retval 32位周期计数
+     */
+    static inline uint32_t AD840X_Time_Now(void)
+    {
+        return AD840X_TIME_NOW();
+    }
+
+    /**
+     * @brief  开始一个非阻塞超时
+     * @param  deadline: 超时指针
+     * @param  ns: 超时时间（ns，不超过AD840X_TIME_MAX_NS）
+     * @retval None
+     */
+    static inline void AD840X_Deadline_Start(AD840X_DeadlineTypeDef *deadline, uint32_t ns)
+    {
+        deadline->cycles = AD840X_Time_Cycles(ns);
+        deadline->start = AD840X_Time_Now();
+    }
+
+    /**
+     * @brief  超时是否已到
+     * @param  deadline: 超时指针
+     * @retval 1-已到，0-未到
+     */
+    static inline uint8_t AD840X_Deadline_Expired(const AD840X_DeadlineTypeDef *deadline)
+    {
+        return (AD840X_Time_Now() - deadline->start) >= deadline->cycles;
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __AD840X_TIME_H */
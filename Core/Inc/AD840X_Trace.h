@@ -0,0 +1,122 @@
+/*
+ * AD840X系列数字电位器驱动库 - 命令跟踪
+ * 雪豹  编写   github.com/2827700630
+ *
+ * 现场调试用：在RAM环形缓冲区中记录每条写入命令做了什么、什么时候做的：
+ *    - 提交时刻和完成（锁存）时刻，单位为AD840X_Time_Now()的计数周期
+ *    - 设备、通道、写入值
+ *    - 走的路径：阻塞发送、回读校验、DMA队列、紧急队列，或者没有上总线（跳过、推迟、邮箱合并）
+ *    - 完成状态
+ * 记录无锁（LDREX/STREX抢占槽位），可在中断中调用，每条十几个周期；缓冲区满后覆盖最旧的记录。
+ *
+ * 在编译选项中定义AD840X_USE_TRACE启用（例如platformio.ini的build_flags加-DAD840X_USE_TRACE），
+ * 不定义时驱动中的跟踪点全部为空，不占用代码和RAM。
+ *
+ * 使用方法：
+ *    AD840X_TraceEntryTypeDef log[16];
+ *    uint32_t n = AD840X_Trace_Read(log, 16);  // 最近16条，从旧到新
+ *    AD840X_Trace_Dump(uart_puts);             // 或逐行输出全部记录
+ */
+
+#ifndef __AD840X_TRACE_H
+#define __AD840X_TRACE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "AD840X.h"
+
+/* 跟踪缓冲区记录数，必须是2的幂，每条20字节 */
+#ifndef AD840X_TRACE_SIZE
+#define AD840X_TRACE_SIZE 64
+#endif
+
+    /* 命令走的路径 */
+    typedef enum
+    {
+        AD840X_TRACE_BLOCKING = 0, // 阻塞发送
+        AD840X_TRACE_VERIFY,       // 回读校验（全双工阻塞）
+        AD840X_TRACE_DMA,          // 普通优先级DMA队列
+        AD840X_TRACE_URGENT,       // 高优先级DMA队列
+        AD840X_TRACE_SKIPPED,      // 与器件中的值相同，没有发送
+        AD840X_TRACE_DEFERRED,     // 推迟期间只记录，AD840X_Defer_End时发送
+        AD840X_TRACE_COALESCED     // 邮箱中尚未发送的旧值被覆盖
+    } AD840X_TracePathTypeDef;
+
+    /* 一条跟踪记录 */
+    typedef struct
+    {
+        uint32_t seq;                // 记录序号，从1递增；0表示槽位正在写入
+        uint32_t t_submit;           // 提交时的AD840X_Time_Now()
+        uint32_t t_done;             // 完成时的AD840X_Time_Now()，不上总线的记录等于t_submit
+        AD840X_HandleTypeDef *hdev;  // 设备
+        uint8_t channel;             // 通道地址
+        uint8_t value;               // 写入值
+        uint8_t path;                // AD840X_TracePathTypeDef
+        volatile uint8_t status;     // 完成状态（HAL_StatusTypeDef），未完成为HAL_BUSY
+    } AD840X_TraceEntryTypeDef;
+
+    /* 逐行输出函数，line以'\n'结尾 */
+    typedef void (*AD840X_TraceOutputTypeDef)(const char *line);
+
+    /**
+     * @brief  记录一条命令
+     * @param  hdev: AD840X设备句柄指针
+     * @param  channel: 通道地址
+     * @param  value: 写入值
+     * @param  path: 路径（AD840X_TracePathTypeDef）
+     * @retval 记录序号，传给AD840X_Trace_Done
+     * @note   可在中断中调用
+     */
+    uint32_t AD840X_Trace_Record(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value, uint8_t path);
+
+    /**
+     * @brief  记录一条不上总线的命令（跳过、推迟、合并），完成时刻等于提交时刻
+     * @param  hdev: AD840X设备句柄指针
+     * @param  channel: 通道地址
+     * @param  value: 写入值
+     * @param  path: 路径（AD840X_TracePathTypeDef）
+     * @note   可在中断中调用
+     * @retval None
+     */
+    void AD840X_Trace_Event(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value, uint8_t path);
+
+    /**
+     * @brief  填写命令的完成时刻和状态
+     * @param  seq: AD840X_Trace_Record返回的序号
+     * @param  status: 完成状态
+     * @note   可在中断中调用；记录已被覆盖时不做任何事
+     * @retval None
+     */
+    void AD840X_Trace_Done(uint32_t seq, HAL_StatusTypeDef status);
+
+    /**
+     * @brief  复制最近的跟踪记录
+     * @param  out: 输出数组
+     * @param  max: 最多复制的条数
+     * @retval 实际复制的条数，按从旧到新排列
+     * @note   正在写入或复制期间被覆盖的记录不会复制，按seq判断是否有缺失
+     */
+    uint32_t AD840X_Trace_Read(AD840X_TraceEntryTypeDef *out, uint32_t max);
+
+    /**
+     * @brief  逐行输出缓冲区中的全部记录（CSV：seq,t_submit,latency,cs_pin,channel,value,path,status）
+     * @param  output: 输出函数，例如串口发送
+     * @note   latency为t_done-t_submit（计数周期），不要在中断中调用
+     * @retval None
+     */
+    void AD840X_Trace_Dump(AD840X_TraceOutputTypeDef output);
+
+    /**
+     * @brief  清空跟踪缓冲区
+     * @note   序号继续递增，不从1重新开始
+     * @retval None
+     */
+    void AD840X_Trace_Clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __AD840X_TRACE_H */
@@ -0,0 +1,164 @@
+/*
+ * AD840X系列数字电位器驱动库 - 传输后端
+ * 雪豹  编写   github.com/2827700630
+ *
+ * 驱动核心（AD840X.c）不直接调用HAL库，所有CS、SPI、SHDN/RS引脚和延时操作
+ * 都通过设备句柄上的传输后端操作表（AD840X_TransportTypeDef）完成。
+ * 更换后端只需要在初始化时传入不同的操作表，不用修改驱动核心代码。
+ *
+ * 已提供的后端：
+ * ------------------------------------------------------
+ * 后端                        transport_ctx             说明
+ * AD840X_Transport_HAL        SPI_HandleTypeDef *       HAL库阻塞传输（AD840X_Init在SPI未配置DMA时使用）
+ * AD840X_Transport_HAL_DMA    SPI_HandleTypeDef *       HAL库DMA传输（AD840X_Init在SPI配置了DMA时使用）
+ * AD840X_Transport_Reg        SPI_TypeDef *             直接读写SPI寄存器，省去HAL句柄加锁和状态机开销
+ * AD840X_Transport_LL(_DMA)   AD840X_LLTypeDef *        LL库阻塞/DMA传输，见AD840X_Transport_LL.h
+ * AD840X_Transport_BitBang    AD840X_BitBangTypeDef *   任意GPIO模拟SPI，不占用SPI外设
+ * AD840X_Transport_Parallel   见AD840X_Parallel.h       多器件共用SCK的并行GPIO模拟SPI
+ * AD840X_Transport_Stub       见Sim/目录                Linux下测试用的器件模型
+ *
+ * 使用方法：
+ *    AD840X_Init_Transport(&hAD840X_1, &AD840X_Transport_Reg, SPI1, AD840X_CS1_GPIO_Port, AD840X_CS1_Pin);
+ * SPI外设仍由CubeMX初始化（MX_SPI1_Init），同一SPI上的设备应使用同一种后端。
+ * 两个HAL后端、AD840X_Init和SPI时钟规划/回调只在HAL_SPI_MODULE_ENABLED时编译，
+ * 其余后端不依赖HAL SPI驱动。
+ */
+
+#ifndef __AD840X_TRANSPORT_H
+#define __AD840X_TRANSPORT_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "AD840X.h"
+
+/* GPIO模拟SPI的SCK半周期延时，主频更高时需要加长 */
+#ifndef AD840X_BITBANG_DELAY
+#define AD840X_BITBANG_DELAY() \
+    do                         \
+    {                          \
+        __NOP();               \
+        __NOP();               \
+    } while (0)
+#endif
+
+    /* GPIO模拟SPI引脚配置 */
+    typedef struct
+    {
+        GPIO_TypeDef *sck_port; // SCK端口
+        uint16_t sck_pin;       // SCK引脚
+        GPIO_TypeDef *sdi_port; // 接器件SDI的端口
+        uint16_t sdi_pin;       // 接器件SDI的引脚
+        GPIO_TypeDef *sdo_port; // 接器件SDO的端口（仅AD8403，回读校验用），不用时为NULL
+        uint16_t sdo_pin;       // 接器件SDO的引脚
+    } AD840X_BitBangTypeDef;
+
+#ifdef HAL_SPI_MODULE_ENABLED
+    extern const AD840X_TransportTypeDef AD840X_Transport_HAL;
+    extern const AD840X_TransportTypeDef AD840X_Transport_HAL_DMA;
+#endif
+    extern const AD840X_TransportTypeDef AD840X_Transport_Reg;
+    extern const AD840X_TransportTypeDef AD840X_Transport_BitBang;
+
+    /**
+     * @brief  确保SPI已使能（CubeMX初始化后SPE为0，HAL在第一次传输时才使能）
+     * @param  spi: SPI外设
+     */
+    static inline void AD840X_Reg_Enable(SPI_TypeDef *spi)
+    {
+        if (!(spi->CR1 & SPI_CR1_SPE))
+        {
+            spi->CR1 |= SPI_CR1_SPE;
+        }
+    }
+
+    /**
+     * @brief  直接写DR寄存器阻塞发送，返回时最后一位已移出
+     * @param  spi: SPI外设
+     * @param  data: 待发送数据
+     * @param  size: 字节数
+     * @note   寄存器后端、AD840X_POLICY_REG和AD840X.hpp的AD840x_SpiReg共用
+     */
+    static inline void AD840X_Reg_Send(SPI_TypeDef *spi, const uint8_t *data, uint16_t size)
+    {
+        AD840X_Reg_Enable(spi);
+        for (uint16_t i = 0; i < size; i++)
+        {
+            while (!(spi->SR & SPI_SR_TXE))
+            {
+            }
+            *(volatile uint8_t *)&spi->DR = data[i];
+        }
+
+        /* 等最后一位移出后才能拉高CS */
+        while (!(spi->SR & SPI_SR_TXE))
+        {
+        }
+        while (spi->SR & SPI_SR_BSY)
+        {
+        }
+
+        /* 全双工模式下丢弃收到的数据并清除OVR标志 */
+        (void)spi->DR;
+        (void)spi->SR;
+    }
+
+    /**
+     * @brief  传输后端的异步发送完成通知
+     * @param  bus_id: 总线标识（设备的transport_ctx）
+     * @note   支持Transmit_DMA的后端在发送完成中断中调用，负责拉高CS并启动队列中的下一帧
+     * @retval None
+     */
+    void AD840X_Transport_TxComplete(void *bus_id);
+
+    /**
+     * @brief  传输后端的异步发送出错通知
+     * @param  bus_id: 总线标识（设备的transport_ctx）
+     * @note   在出错中断中调用，丢弃当前帧（完成状态为HAL_ERROR）并启动队列中的下一帧
+     * @retval None
+     */
+    void AD840X_Transport_TxError(void *bus_id);
+
+    /**
+     * @brief  自己驱动CS和数据线的后端（例如多通道并行GPIO）在发送前调用
+     * @param  hdev: AD840X设备句柄指针
+     * @param  channel: 通道地址（由调用者保证小于num_channels）
+     * @param  value: 8位电阻值（0-255）
+     * @param  trace: 输出，跟踪记录序号，交给AD840X_Transport_WriteEnd
+     * @retval 1-需要发送，0-跳过（重复值或推迟写入，与AD840X_WriteAsync相同）
+     * @note   更新shadow；需要发送时会唤醒自动断电的器件
+     */
+    uint8_t AD840X_Transport_WriteBegin(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value, uint32_t *trace);
+
+    /**
+     * @brief  帧锁存（CS拉高）之后调用，更新统计、同步状态和跟踪记录
+     * @param  hdev: AD840X设备句柄指针
+     * @param  channel: 通道地址
+     * @param  value: 8位电阻值（0-255）
+     * @param  status: 传输结果
+     * @param  trace: AD840X_Transport_WriteBegin输出的跟踪记录序号
+     * @retval None
+     */
+    void AD840X_Transport_WriteEnd(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value,
+                                   HAL_StatusTypeDef status, uint32_t trace);
+
+    /**
+     * @brief  占有设备所在的总线（启用RTOS时），与AD840X_Transport_Unlock成对使用
+     * @param  hdev: AD840X设备句柄指针
+     * @retval None
+     */
+    void AD840X_Transport_Lock(AD840X_HandleTypeDef *hdev);
+
+    /**
+     * @brief  释放AD840X_Transport_Lock占有的总线
+     * @param  hdev: AD840X设备句柄指针
+     * @retval None
+     */
+    void AD840X_Transport_Unlock(AD840X_HandleTypeDef *hdev);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __AD840X_TRANSPORT_H */
@@ -0,0 +1,85 @@
+/*
+ * AD840X系列数字电位器驱动库 - LL库传输后端
+ * 雪豹  编写   github.com/2827700630
+ *
+ * 基于STM32F1 LL库（SPI、DMA、GPIO）的传输后端，写入语义与HAL后端相同：
+ *    - 未配置DMA通道时阻塞发送，返回时帧已锁存
+ *    - 配置了DMA通道时帧进入总线队列后立即返回，由DMA完成中断拉高CS并启动下一帧
+ * 不经过HAL的SPI句柄，也不依赖stm32f1xx_hal_spi.c（与HAL后端的周期数对比见AD840X_Benchmark.h），
+ * 所有AD840X设备都改用本后端后，可以在stm32f1xx_hal_conf.h中注释掉HAL_SPI_MODULE_ENABLED，
+ * 让HAL SPI驱动整个从固件中去掉。
+ *
+ * CubeMX配置：
+ *    1. SPI按AD840X.h中的要求配置（Mode 0、8位、MSB先发），Project Manager -> Advanced Settings
+ *       中把SPI改为LL驱动；HAL_SPI_MODULE_ENABLED不再需要
+ *    2. 使用DMA时在SPI的DMA Settings中添加TX通道（SPI1_TX为DMA1 Channel3，SPI2_TX为DMA1 Channel5），
+ *       并在NVIC中使能该通道的中断
+ *    3. 在stm32f1xx_it.c对应的DMA1_ChannelX_IRQHandler中调用AD840X_LL_DMA_IRQHandler
+ *
+ * 使用方法：
+ *    AD840X_LLTypeDef ad840x_ll_spi1;
+ *    AD840X_LL_Init(&ad840x_ll_spi1, SPI1, DMA1, LL_DMA_CHANNEL_3); // 不用DMA时传NULL, 0
+ *    AD840X_LL_PlanClock(&ad840x_ll_spi1, AD840X_SPI_MAX_CLOCK_HZ);
+ *    AD840X_Init_Transport(&hAD840X_1, &AD840X_Transport_LL_DMA, &ad840x_ll_spi1, AD840X_CS1_GPIO_Port, AD840X_CS1_Pin);
+ * 不用DMA时改用AD840X_Transport_LL。同一SPI上的所有设备共用同一个AD840X_LLTypeDef，它同时作为总线标识。
+ */
+
+#ifndef __AD840X_TRANSPORT_LL_H
+#define __AD840X_TRANSPORT_LL_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "AD840X_Transport.h"
+#include "stm32f1xx_ll_spi.h"
+#include "stm32f1xx_ll_dma.h"
+#include "stm32f1xx_ll_gpio.h"
+
+/* HAL引脚号（GPIO_PIN_x）转换为LL引脚掩码（LL_GPIO_PIN_x） */
+#define AD840X_LL_PIN(pin) ((uint32_t)(pin) << GPIO_PIN_MASK_POS)
+
+    /* LL后端的SPI总线 */
+    typedef struct
+    {
+        SPI_TypeDef *spi;     // SPI外设
+        DMA_TypeDef *dma;     // TX方向的DMA控制器，不使用DMA时为NULL
+        uint32_t dma_channel; // TX方向的DMA通道（LL_DMA_CHANNEL_x）
+    } AD840X_LLTypeDef;
+
+    extern const AD840X_TransportTypeDef AD840X_Transport_LL;
+    extern const AD840X_TransportTypeDef AD840X_Transport_LL_DMA;
+
+    /**
+     * @brief  初始化LL后端的SPI总线
+     * @param  ll: 总线指针，同一SPI上的设备共用
+     * @param  spi: SPI外设（SPI1/SPI2）
+     * @param  dma: TX方向的DMA控制器，不使用DMA时传NULL
+     * @param  dma_channel: TX方向的DMA通道（LL_DMA_CHANNEL_x），不使用DMA时传0
+     * @note   在MX_SPIx_Init、MX_DMA_Init之后调用。会配置DMA通道的传输方向、数据宽度并打开完成中断
+     * @retval None
+     */
+    void AD840X_LL_Init(AD840X_LLTypeDef *ll, SPI_TypeDef *spi, DMA_TypeDef *dma, uint32_t dma_channel);
+
+    /**
+     * @brief  根据当前PCLK选择不超过上限的最快SPI分频系数
+     * @param  ll: 总线指针
+     * @param  max_hz: 允许的最高SCK频率，一般传AD840X_SPI_MAX_CLOCK_HZ
+     * @retval 实际的SCK频率（Hz）
+     * @note   与AD840X_SPI_PlanClock相同，用于没有HAL SPI句柄的场合
+     */
+    uint32_t AD840X_LL_PlanClock(AD840X_LLTypeDef *ll, uint32_t max_hz);
+
+    /**
+     * @brief  DMA发送完成中断处理
+     * @param  ll: 总线指针
+     * @note   在DMA1_ChannelX_IRQHandler中调用，负责拉高CS并启动队列中的下一帧
+     * @retval None
+     */
+    void AD840X_LL_DMA_IRQHandler(AD840X_LLTypeDef *ll);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __AD840X_TRANSPORT_LL_H */
@@ -3,10 +3,587 @@
  * 雪豹  编写
  */
 #include "AD840X.h"
+#include "AD840X_Transport.h"
+#include "AD840X_Time.h"
+#include "AD840X_Atomic.h"
+#ifdef AD840X_USE_RTOS
+#include "AD840X_OS.h"
 
-/* 用于DMA传输的全局变量 */
-static uint8_t tx_data_dma[2];
-static AD840X_HandleTypeDef *current_dma_device = NULL;
+/* 多任务访问同一总线时加锁，等待DMA时阻塞在信号量上（见AD840X_OS.h） */
+#define AD840X_BUS_LOCK(bus) ((bus) != NULL ? AD840X_OS_BusLock(bus) : (void)0)
+#define AD840X_BUS_UNLOCK(bus) ((bus) != NULL ? AD840X_OS_BusUnlock(bus) : (void)0)
+#define AD840X_BUS_WAIT(bus) AD840X_OS_BusWait(bus)
+#define AD840X_BUS_SIGNAL(bus) AD840X_OS_BusSignalFromISR(bus)
+#else
+/* 裸机：单一执行流，等待DMA时空转 */
+#define AD840X_BUS_LOCK(bus) ((void)0)
+#define AD840X_BUS_UNLOCK(bus) ((void)0)
+#define AD840X_BUS_WAIT(bus) ((void)0)
+#define AD840X_BUS_SIGNAL(bus) ((void)0)
+#endif
+
+#ifdef AD840X_USE_TRACE
+#include "AD840X_Trace.h"
+
+/* 命令跟踪点（见AD840X_Trace.h） */
+#define AD840X_TRACE(hdev, channel, value, path) AD840X_Trace_Record(hdev, channel, value, path)
+#define AD840X_TRACE_DONE(seq, status) AD840X_Trace_Done(seq, status)
+#define AD840X_TRACE_EVENT(hdev, channel, value, path) AD840X_Trace_Event(hdev, channel, value, path)
+#define AD840X_TRACE_FRAME(frame, path) \
+    ((frame)->trace = AD840X_Trace_Record((frame)->hdev, (frame)->tx[0], (frame)->tx[1], path))
+#define AD840X_TRACE_FRAME_DONE(frame, status) AD840X_Trace_Done((frame)->trace, status)
+#else
+/* 不跟踪：跟踪点为空 */
+#define AD840X_TRACE(hdev, channel, value, path) 0U
+#define AD840X_TRACE_DONE(seq, status) ((void)(seq))
+#define AD840X_TRACE_EVENT(hdev, channel, value, path) ((void)0)
+#define AD840X_TRACE_FRAME(frame, path) ((void)0)
+#define AD840X_TRACE_FRAME_DONE(frame, status) ((void)0)
+#endif
+
+#ifdef AD840X_USE_ITM
+#include "AD840X_ITM.h"
+
+/* 值锁存后发送ITM遥测数据包（见AD840X_ITM.h） */
+#define AD840X_TELEMETRY(hdev, channel, value) AD840X_ITM_Send(hdev, channel, value)
+#else
+#define AD840X_TELEMETRY(hdev, channel, value) ((void)0)
+#endif
+
+/* 写入路径（见AD840X.h中的AD840X_POLICY）：固定路径时判断条件是常量，其余分支由编译器去掉 */
+#if AD840X_POLICY == AD840X_POLICY_RUNTIME
+#define AD840X_PATH_VERIFY(hdev) ((hdev)->verify)
+#define AD840X_PATH_DMA(hdev) ((hdev)->use_dma)
+#define AD840X_PATH_DMA_INIT(transport) ((transport)->Transmit_DMA != NULL)
+#elif AD840X_POLICY == AD840X_POLICY_DMA
+#define AD840X_PATH_VERIFY(hdev) 0
+#define AD840X_PATH_DMA(hdev) 1
+#define AD840X_PATH_DMA_INIT(transport) ((transport)->Transmit_DMA != NULL ? 1 : (Error_Handler(), 0))
+#else
+#define AD840X_PATH_VERIFY(hdev) 0
+#define AD840X_PATH_DMA(hdev) 0
+#define AD840X_PATH_DMA_INIT(transport) 0
+#endif
+
+#if AD840X_POLICY == AD840X_POLICY_REG
+/* CS写BSRR、数据写DR，内联在AD840X_Write中 */
+#define AD840X_SELECT(hdev, active) \
+    ((hdev)->cs_port->BSRR = (active) ? ((uint32_t)(hdev)->cs_pin << 16) : (hdev)->cs_pin)
+#define AD840X_TRANSMIT(hdev, data, size) \
+    (AD840X_Reg_Send((SPI_TypeDef *)(hdev)->transport_ctx, data, size), HAL_OK)
+#else
+#define AD840X_SELECT(hdev, active) (hdev)->transport->Select(hdev, active)
+#define AD840X_TRANSMIT(hdev, data, size) (hdev)->transport->Transmit(hdev, data, size)
+#endif
+
+/* 已注册的SPI总线，每个SPI外设一个 */
+static AD840X_BusTypeDef ad840x_buses[AD840X_MAX_BUSES];
+
+/* 推迟写入期间（AD840X_Defer_Begin到AD840X_Defer_End之间）为1 */
+static volatile uint8_t ad840x_deferring;
+
+/**
+ * @brief  查找总线，不存在时注册一个新的
+ * @param  id: 总线标识（HAL后端为SPI句柄，寄存器/LL后端为SPI外设）
+ * @retval 总线指针
+ * @note   超过AD840X_MAX_BUSES时调用Error_Handler
+ */
+static AD840X_BusTypeDef *AD840X_Bus_Get(void *id)
+{
+    for (uint8_t i = 0; i < AD840X_MAX_BUSES; i++)
+    {
+        if (ad840x_buses[i].id == id)
+        {
+            return &ad840x_buses[i];
+        }
+    }
+    for (uint8_t i = 0; i < AD840X_MAX_BUSES; i++)
+    {
+        if (ad840x_buses[i].id == NULL)
+        {
+            ad840x_buses[i].id = id;
+            ad840x_buses[i].lane[AD840X_PRIORITY_NORMAL].frames = ad840x_buses[i].queue;
+            ad840x_buses[i].lane[AD840X_PRIORITY_NORMAL].mask = AD840X_BUS_QUEUE_SIZE - 1U;
+            ad840x_buses[i].lane[AD840X_PRIORITY_HIGH].frames = ad840x_buses[i].urgent_queue;
+            ad840x_buses[i].lane[AD840X_PRIORITY_HIGH].mask = AD840X_BUS_URGENT_SIZE - 1U;
+#ifdef AD840X_USE_RTOS
+            AD840X_OS_BusInit(&ad840x_buses[i]);
+#endif
+            return &ad840x_buses[i];
+        }
+    }
+
+    /* 总线数量超过AD840X_MAX_BUSES，需要增大该宏 */
+    Error_Handler();
+    return NULL;
+}
+
+/**
+ * @brief  查找已注册的总线
+ * @param  id: 总线标识
+ * @retval 总线指针，未注册时返回NULL
+ */
+static AD840X_BusTypeDef *AD840X_Bus_Find(void *id)
+{
+    for (uint8_t i = 0; i < AD840X_MAX_BUSES; i++)
+    {
+        if (ad840x_buses[i].id == id)
+        {
+            return &ad840x_buses[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief  总线上是否还有待发送的帧
+ * @param  bus: 总线指针
+ * @retval 1-有，0-所有优先级的队列都已发完
+ */
+static uint8_t AD840X_Bus_Pending(const AD840X_BusTypeDef *bus)
+{
+    for (uint8_t p = 0; p < AD840X_PRIORITY_COUNT; p++)
+    {
+        if (bus->lane[p].head != bus->lane[p].tail)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief  帧结束后更新synced（跳过重复写入的比较基准）
+ * @param  hdev: AD840X设备句柄指针
+ * @param  channel: 通道地址
+ * @param  value: 帧中的8位电阻值
+ * @param  status: 帧的完成状态
+ * @note   只有成功锁存、且锁存的正是shadow中的值时才置位；出错、或锁存的值与shadow不同
+ *         （SPI复位写中值、之后又有新的写入）时清除。可在DMA完成中断中调用
+ */
+static void AD840X_Synced_Update(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value,
+                                 HAL_StatusTypeDef status)
+{
+    if (status == HAL_OK && (hdev->shadow_valid & (1U << channel)) &&
+        *(volatile uint8_t *)&hdev->shadow[channel] == value)
+    {
+        AD840X_Atomic_Or(&hdev->synced, 1UL << channel);
+    }
+    else
+    {
+        AD840X_Atomic_And(&hdev->synced, ~(1UL << channel));
+    }
+}
+
+/**
+ * @brief  结束正在发送（或被跳过）的帧：拉高CS，记录状态，出队并调用完成回调
+ * @param  bus: 总线指针
+ * @param  status: 完成状态
+ * @note   调用者占有总线（busy=1），帧在bus->active队列的队首
+ */
+static void AD840X_Bus_Retire(AD840X_BusTypeDef *bus, HAL_StatusTypeDef status)
+{
+    AD840X_LaneTypeDef *lane = &bus->lane[bus->active];
+    AD840X_FrameTypeDef *frame = &lane->frames[lane->tail & lane->mask];
+    AD840X_HandleTypeDef *hdev = frame->hdev;
+    AD840X_CallbackTypeDef callback = frame->callback;
+    void *arg = frame->arg;
+
+    /* CS拉高（满足tCSW >10ns，Page10 Table4）*/
+    hdev->transport->Select(hdev, 0);
+
+    if (status == HAL_OK)
+    {
+        hdev->stats.frames++;
+        hdev->stats.bytes += 2U;
+        bus->frames++;
+        AD840X_TELEMETRY(hdev, frame->tx[0], frame->tx[1]);
+    }
+    else if (!frame->cancel)
+    {
+        hdev->stats.errors++;
+    }
+    AD840X_Synced_Update(hdev, frame->tx[0], frame->tx[1], status);
+
+    AD840X_TRACE_FRAME_DONE(frame, status);
+    frame->status = (uint8_t)status;
+    __DMB(); // 状态先于tail可见；tail加1后槽位可能被任务复用，回调参数已取出
+    lane->tail++;
+
+    if (callback != NULL)
+    {
+        callback(hdev, status, arg);
+    }
+}
+
+/**
+ * @brief  用DMA发送下一帧，高优先级队列优先
+ * @param  bus: 总线指针
+ * @note   调用者必须已经占有总线（busy=1）
+ * @note   被取消的帧以HAL_ERROR结束，不占用总线时间；后端拒绝启动DMA时该帧以HAL_ERROR结束，
+ *         继续尝试下一帧；所有队列发完时释放总线
+ * @note   这两种帧的回调在本函数的调用者上下文中执行：从AD840X_Bus_Kick进入时可能是占有总线互斥量的任务
+ */
+static void AD840X_Bus_StartNext(AD840X_BusTypeDef *bus)
+{
+    while (1)
+    {
+        AD840X_LaneTypeDef *lane = NULL;
+        AD840X_FrameTypeDef *frame;
+
+        /* 帧间隙：从最高优先级开始找第一个非空队列 */
+        for (uint8_t p = AD840X_PRIORITY_COUNT; p-- > 0U;)
+        {
+            if (bus->lane[p].head != bus->lane[p].tail)
+            {
+                lane = &bus->lane[p];
+                bus->active = p;
+                break;
+            }
+        }
+        if (lane == NULL)
+        {
+            bus->busy_cycles += AD840X_Time_Now() - bus->busy_since;
+            bus->busy = 0;
+            return;
+        }
+
+        __DMB(); // 读到head后再读帧内容
+        frame = &lane->frames[lane->tail & lane->mask];
+        if (frame->cancel)
+        {
+            bus->flushed++;
+            AD840X_Bus_Retire(bus, HAL_ERROR);
+            continue;
+        }
+        if (bus->active == AD840X_PRIORITY_HIGH)
+        {
+            uint32_t waited = bus->lane[AD840X_PRIORITY_NORMAL].tail - frame->mark;
+
+            if (waited > bus->urgent_wait_max)
+            {
+                bus->urgent_wait_max = waited;
+            }
+        }
+
+        /* CS拉低（满足tCSS >10ns，Page10 Table4）*/
+        frame->hdev->transport->Select(frame->hdev, 1);
+
+        /* 帧数据在发送完成前一直留在队列中，DMA直接从队列读取 */
+        if (frame->hdev->transport->Transmit_DMA(frame->hdev, frame->tx, 2) == HAL_OK)
+        {
+            return;
+        }
+
+        bus->errors++;
+        AD840X_Bus_Retire(bus, HAL_ERROR);
+    }
+}
+
+/**
+ * @brief  总线空闲且队列非空时启动DMA发送
+ * @param  bus: 总线指针
+ * @note   可在中断中调用
+ */
+static void AD840X_Bus_Kick(AD840X_BusTypeDef *bus)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint8_t start = 0;
+
+    /* 与DMA完成中断互斥地检查并占有总线，临界区只有几条指令 */
+    __disable_irq();
+    if (!bus->busy && AD840X_Bus_Pending(bus))
+    {
+        bus->busy = 1;
+        bus->busy_since = AD840X_Time_Now();
+        start = 1;
+    }
+    __set_PRIMASK(primask);
+
+    if (start)
+    {
+        AD840X_Bus_StartNext(bus);
+    }
+}
+
+/**
+ * @brief  填写一帧
+ * @param  frame: 帧槽位
+ * @param  hdev: AD840X设备句柄指针
+ * @param  tx: 帧数据
+ * @param  seq: 帧序号
+ * @param  callback: 完成回调，不需要时为NULL
+ * @param  arg: 回调参数
+ */
+static void AD840X_Frame_Fill(AD840X_FrameTypeDef *frame, AD840X_HandleTypeDef *hdev, const uint8_t *tx,
+                              uint32_t seq, AD840X_CallbackTypeDef callback, void *arg)
+{
+    frame->hdev = hdev;
+    frame->tx[0] = tx[0];
+    frame->tx[1] = tx[1];
+    frame->status = HAL_BUSY;
+    frame->cancel = 0;
+    frame->seq = seq;
+    frame->callback = callback;
+    frame->arg = arg;
+}
+
+/**
+ * @brief  把一帧放入总线的普通优先级DMA队列
+ * @param  hdev: AD840X设备句柄指针
+ * @param  tx: 帧数据
+ * @param  callback: 完成回调，不需要时为NULL
+ * @param  arg: 回调参数
+ * @retval 帧序号
+ * @note   队列满时等待DMA完成中断腾出空间；调用者持有总线（启用RTOS时），队列只有一个写入者
+ */
+static uint32_t AD840X_Bus_Enqueue(AD840X_HandleTypeDef *hdev, const uint8_t *tx,
+                                   AD840X_CallbackTypeDef callback, void *arg)
+{
+    AD840X_BusTypeDef *bus = hdev->bus;
+    AD840X_LaneTypeDef *lane = &bus->lane[AD840X_PRIORITY_NORMAL];
+    uint32_t seq;
+
+    if (lane->head - lane->tail >= AD840X_BUS_QUEUE_SIZE)
+    {
+        /* 总线跟不上写入速度 */
+        hdev->stats.waits++;
+        bus->waits++;
+        while (lane->head - lane->tail >= AD840X_BUS_QUEUE_SIZE)
+        {
+            AD840X_BUS_WAIT(bus);
+        }
+    }
+
+    seq = lane->head;
+    AD840X_Frame_Fill(&lane->frames[seq & lane->mask], hdev, tx, seq, callback, arg);
+    AD840X_TRACE_FRAME(&lane->frames[seq & lane->mask], AD840X_TRACE_DMA);
+    __DMB(); // 帧内容先于head对中断可见
+    lane->head = seq + 1U;
+
+    AD840X_Bus_Kick(bus);
+    return seq;
+}
+
+/**
+ * @brief  把一帧放入总线的高优先级DMA队列，可选取消同一通道排队中的普通帧
+ * @param  hdev: AD840X设备句柄指针
+ * @param  tx: 帧数据
+ * @param  flush: 1-取消普通队列中同一设备同一通道的帧
+ * @param  callback: 完成回调，不需要时为NULL
+ * @param  arg: 回调参数
+ * @param  seq: 返回帧序号
+ * @retval 1-成功，0-高优先级队列已满
+ * @note   可在中断和任意任务中调用：整个过程在关中断临界区内完成，不使用总线互斥量。
+ *         临界区最长是扫描一遍普通队列（AD840X_BUS_QUEUE_SIZE帧）
+ */
+static uint8_t AD840X_Bus_EnqueueUrgent(AD840X_HandleTypeDef *hdev, const uint8_t *tx, uint8_t flush,
+                                        AD840X_CallbackTypeDef callback, void *arg, uint32_t *seq)
+{
+    AD840X_BusTypeDef *bus = hdev->bus;
+    AD840X_LaneTypeDef *lane = &bus->lane[AD840X_PRIORITY_HIGH];
+    AD840X_LaneTypeDef *normal = &bus->lane[AD840X_PRIORITY_NORMAL];
+    uint32_t primask = __get_PRIMASK();
+    AD840X_FrameTypeDef *frame;
+
+    __disable_irq();
+    if (lane->head - lane->tail >= AD840X_BUS_URGENT_SIZE)
+    {
+        hdev->stats.waits++;
+        __set_PRIMASK(primask);
+        return 0;
+    }
+
+    /* 只扫描已发布的普通帧；正在发送的那一帧取消不了，紧急帧会紧跟在它后面 */
+    if (flush)
+    {
+        for (uint32_t i = normal->tail; i != normal->head; i++)
+        {
+            AD840X_FrameTypeDef *f = &normal->frames[i & normal->mask];
+
+            if (f->hdev == hdev && f->tx[0] == tx[0])
+            {
+                f->cancel = 1;
+            }
+        }
+    }
+
+    *seq = lane->head;
+    frame = &lane->frames[*seq & lane->mask];
+    AD840X_Frame_Fill(frame, hdev, tx, *seq, callback, arg);
+    AD840X_TRACE_FRAME(frame, AD840X_TRACE_URGENT);
+    frame->mark = normal->tail;
+    __DMB(); // 帧内容先于head对中断可见
+    lane->head = *seq + 1U;
+    __set_PRIMASK(primask);
+
+    AD840X_Bus_Kick(bus);
+    return 1;
+}
+
+/**
+ * @brief  等待总线DMA队列发送完毕
+ * @param  bus: 总线指针
+ */
+static void AD840X_Bus_WaitIdle(AD840X_BusTypeDef *bus)
+{
+    while (bus->busy || AD840X_Bus_Pending(bus))
+    {
+        AD840X_BUS_WAIT(bus);
+    }
+}
+
+/**
+ * @brief  当前帧结束：拉高CS，出队并启动下一帧
+ * @param  bus: 总线指针
+ * @param  status: 当前帧的完成状态
+ * @note   在SPI中断上下文中调用，不加锁：tail只由中断修改，普通队列的head只由持有总线的任务修改，
+ *         高优先级队列的head在关中断临界区内修改
+ */
+static void AD840X_Bus_FrameDone(AD840X_BusTypeDef *bus, HAL_StatusTypeDef status)
+{
+    if (status != HAL_OK)
+    {
+        bus->errors++;
+    }
+    AD840X_Bus_Retire(bus, status);
+    AD840X_Bus_StartNext(bus);
+
+    /* 唤醒等待队列空间或等待发送完毕的任务 */
+    AD840X_BUS_SIGNAL(bus);
+}
+
+/**
+ * @brief  全双工发送一帧，并读出SDO移出的上一帧10位数据字
+ * @param  hdev: AD840X设备句柄指针
+ * @param  tx: 待发送的2字节数据
+ * @param  word: 返回SDO回读的上一帧数据字（10位）
+ * @retval 传输后端的状态，不是HAL_OK时word无效
+ * @note   16个时钟中前10个移出移位寄存器中的旧数据字，后6个是本帧的前导0（Page22 Figure50）
+ */
+static HAL_StatusTypeDef AD840X_Frame_Loopback(AD840X_HandleTypeDef *hdev, uint8_t *tx, uint16_t *word)
+{
+    uint8_t rx[2] = {0};
+    HAL_StatusTypeDef status;
+
+    /* 阻塞传输前先让总线上的DMA队列发完 */
+    if (hdev->bus != NULL)
+    {
+        AD840X_Bus_WaitIdle(hdev->bus);
+    }
+
+    hdev->transport->Select(hdev, 1);
+    status = hdev->transport->TransmitReceive(hdev, tx, rx, 2);
+    hdev->transport->Select(hdev, 0);
+    if (status == HAL_OK)
+    {
+        hdev->stats.frames++;
+        hdev->stats.bytes += 2U;
+    }
+
+    *word = (uint16_t)(((uint16_t)rx[0] << 8) | rx[1]) >> 6;
+    return status;
+}
+
+/**
+ * @brief  带回读校验的写操作（仅AD8403）
+ * @param  hdev: AD840X设备句柄指针
+ * @param  tx: 待发送的2字节数据
+ * @note   每帧回读的都是上一帧数据字，校验不增加总线时间；
+ *         不一致时先重发上一帧再重发本帧，两帧回读都正确才算成功
+ * @note   传输本身出错（超时、后端不能接收）时不重试，直接返回HAL_ERROR，下一帧不做比较
+ * @retval HAL_OK，重试用完仍不一致或传输出错时返回HAL_ERROR
+ */
+static HAL_StatusTypeDef AD840X_Write_Verified(AD840X_HandleTypeDef *hdev, uint8_t *tx)
+{
+    uint16_t word = (uint16_t)(((uint16_t)tx[0] << 8) | tx[1]);
+    uint16_t rx_word;
+    uint16_t rx_prev;
+    uint8_t prev[2];
+    uint8_t retries = 0;
+    uint8_t ok;
+
+    if (AD840X_Frame_Loopback(hdev, tx, &rx_word) != HAL_OK)
+    {
+        /* 回读值无效，移位寄存器中的内容也不再确定 */
+        hdev->last_word_valid = 0;
+        return HAL_ERROR;
+    }
+    ok = (rx_word == hdev->last_word) || !hdev->last_word_valid;
+
+    while (!ok)
+    {
+        hdev->verify_errors++;
+        if (retries >= hdev->verify_max_retries)
+        {
+            break;
+        }
+        retries++;
+        hdev->verify_retry_count++;
+        hdev->stats.retries++;
+
+        /* 上一帧可能在线路上出错，重发上一帧（回读应为本帧），再重发本帧（回读应为上一帧） */
+        prev[0] = (uint8_t)(hdev->last_word >> 8);
+        prev[1] = (uint8_t)hdev->last_word;
+        if (AD840X_Frame_Loopback(hdev, prev, &rx_prev) != HAL_OK ||
+            AD840X_Frame_Loopback(hdev, tx, &rx_word) != HAL_OK)
+        {
+            hdev->last_word_valid = 0;
+            return HAL_ERROR;
+        }
+        ok = (rx_prev == word) && (rx_word == hdev->last_word);
+    }
+
+    /* 本帧已移入器件，作为下一帧的校验基准 */
+    hdev->last_word = word;
+    hdev->last_word_valid = 1;
+    return ok ? HAL_OK : HAL_ERROR;
+}
+
+#ifdef HAL_SPI_MODULE_ENABLED
+/**
+ * @brief  获取SPI外设所在APB总线的时钟频率
+ * @param  hspi: SPI句柄指针
+ * @retval PCLK频率（Hz）
+ * @note   STM32F1的SPI1挂在APB2上，SPI2/SPI3挂在APB1上
+ */
+static uint32_t AD840X_SPI_GetPCLK(SPI_HandleTypeDef *hspi)
+{
+    if (hspi->Instance == SPI1)
+    {
+        return HAL_RCC_GetPCLK2Freq();
+    }
+    return HAL_RCC_GetPCLK1Freq();
+}
+
+/**
+ * @brief  修改SPI分频系数
+ * @param  hspi: SPI句柄指针
+ * @param  br: CR1寄存器BR[2:0]的值（分频系数为2^(br+1)）
+ * @note   BR只能在SPI关闭时修改，HAL库在下一次传输时会重新使能SPI
+ */
+static void AD840X_SPI_SetPrescaler(SPI_HandleTypeDef *hspi, uint32_t br)
+{
+    AD840X_BusTypeDef *bus = AD840X_Bus_Find(hspi);
+
+    if (bus == NULL)
+    {
+        bus = AD840X_Bus_Find(hspi->Instance); // 寄存器后端以SPI外设为总线标识
+    }
+
+    /* 等待DMA队列和当前帧发送完毕 */
+    if (bus != NULL)
+    {
+        AD840X_Bus_WaitIdle(bus);
+    }
+    while (__HAL_SPI_GET_FLAG(hspi, SPI_FLAG_BSY))
+    {
+    }
+
+    __HAL_SPI_DISABLE(hspi);
+    MODIFY_REG(hspi->Instance->CR1, SPI_CR1_BR, br << SPI_CR1_BR_Pos);
+    hspi->Init.BaudRatePrescaler = br << SPI_CR1_BR_Pos; // 保持HAL句柄与寄存器一致
+}
 
 /**
  * @brief  初始化AD840X数字电位器
@@ -20,8 +597,59 @@ static AD840X_HandleTypeDef *current_dma_device = NULL;
 void AD840X_Init(AD840X_HandleTypeDef *hdev, SPI_HandleTypeDef *hspi, 
                 GPIO_TypeDef *cs_port, uint16_t cs_pin)
 {
-    /* 初始化设备句柄 */
+#if AD840X_POLICY == AD840X_POLICY_REG
+    /* 编译时固定为寄存器直接访问，写入不经过HAL句柄 */
+    AD840X_Init_Transport(hdev, &AD840X_Transport_Reg, hspi->Instance, cs_port, cs_pin);
+#else
+    /* 检查SPI是否配置了DMA，选择HAL库DMA或阻塞传输后端 */
+    if (hspi->hdmatx != NULL)
+    {
+        AD840X_Init_Transport(hdev, &AD840X_Transport_HAL_DMA, hspi, cs_port, cs_pin); // SPI已配置DMA
+    }
+    else
+    {
+        AD840X_Init_Transport(hdev, &AD840X_Transport_HAL, hspi, cs_port, cs_pin); // SPI未配置DMA
+    }
+#endif
+
+    /* 时钟规划等HAL相关功能需要SPI句柄；阻塞后端也注册总线，便于SPI时钟修改时同步 */
     hdev->hspi = hspi;
+    hdev->bus = AD840X_Bus_Get(hdev->transport_ctx); // 与AD840X_Init_Transport使用同一个总线标识
+}
+#endif
+
+/**
+ * @brief  使用指定的传输后端初始化AD840X数字电位器
+ * @param  hdev: AD840X设备句柄指针
+ * @param  transport: 传输后端操作表
+ * @param  transport_ctx: 传输后端私有数据（由后端解释）
+ * @param  cs_port: CS引脚端口
+ * @param  cs_pin: CS引脚
+ * @note   用于不经过HAL SPI的后端（例如并行GPIO模拟SPI），这类设备不使用DMA队列和回读校验
+ * @note   AD840X_POLICY为AD840X_POLICY_REG时只能传AD840X_Transport_Reg，否则调用Error_Handler
+ * @retval None
+ */
+void AD840X_Init_Transport(AD840X_HandleTypeDef *hdev, const AD840X_TransportTypeDef *transport,
+                           void *transport_ctx, GPIO_TypeDef *cs_port, uint16_t cs_pin)
+{
+    static const AD840X_StatsTypeDef stats_zero = {0};
+    static uint8_t next_id;
+
+#if AD840X_POLICY == AD840X_POLICY_REG
+    /* 写入路径把transport_ctx直接当作SPI外设访问，其他后端的transport_ctx不是SPI_TypeDef */
+    if (transport != &AD840X_Transport_Reg)
+    {
+        Error_Handler();
+    }
+#endif
+
+    /* 初始化设备句柄 */
+#ifdef HAL_SPI_MODULE_ENABLED
+    hdev->hspi = NULL;
+#endif
+    hdev->id = next_id++;
+    hdev->transport = transport;
+    hdev->transport_ctx = transport_ctx;
     hdev->cs_port = cs_port;
     hdev->cs_pin = cs_pin;
 
@@ -31,18 +659,53 @@ void AD840X_Init(AD840X_HandleTypeDef *hdev, SPI_HandleTypeDef *hspi,
     hdev->rs_port = NULL;
     hdev->rs_pin = PIN_NOT_CONNECTED;
 
-    /* 检查SPI是否配置了DMA */
-    if (hspi->hdmatx != NULL)
+    /* 延时和计时使用DWT周期计数器 */
+    AD840X_Time_Init();
+
+    /* 默认按AD8403（4通道）处理，可通过AD840X_Config_Model修改 */
+    hdev->model = AD840X_MODEL_AD8403;
+    hdev->num_channels = (uint8_t)AD840X_MODEL_AD8403;
+
+    /* 默认不启用回读校验 */
+    hdev->verify = 0;
+    hdev->verify_max_retries = 0;
+    hdev->verify_errors = 0;
+    hdev->verify_retry_count = 0;
+    hdev->last_word = 0;
+    hdev->last_word_valid = 0;
+    hdev->mailbox_dirty = 0;
+    hdev->shadow_valid = 0;
+
+    /* 默认不自动断电 */
+    hdev->auto_shdn_ms = 0;
+    hdev->idle_since = 0;
+    hdev->powered_down = 0;
+    hdev->wakeups = 0;
+    hdev->deferred = 0;
+
+    /* 默认每次写入都发送，统计从0开始 */
+    hdev->skip_redundant = 0;
+    hdev->synced = 0;
+    hdev->stats = stats_zero;
+
+    /* 后端支持DMA时使用总线队列，同一transport_ctx的设备共享一条总线 */
+    if (AD840X_PATH_DMA_INIT(transport))
     {
-        hdev->use_dma = 1; // SPI已配置DMA
+        hdev->use_dma = 1;
+        hdev->bus = AD840X_Bus_Get(transport_ctx);
     }
     else
     {
-        hdev->use_dma = 0; // SPI未配置DMA
+        hdev->use_dma = 0;
+#ifdef AD840X_USE_RTOS
+        hdev->bus = AD840X_Bus_Get(transport_ctx); // 阻塞后端也需要总线互斥量
+#else
+        hdev->bus = NULL;
+#endif
     }
 
     /* 初始化时将CS引脚拉高 */
-    HAL_GPIO_WritePin(hdev->cs_port, hdev->cs_pin, GPIO_PIN_SET);
+    hdev->transport->Select(hdev, 0);
 }
 
 /**
@@ -72,7 +735,7 @@ void AD840X_Config_Pins(AD840X_HandleTypeDef *hdev,
         hdev->shdn_pin = shdn_pin;
         
         /* 默认设置为高电平（正常工作模式） */
-        HAL_GPIO_WritePin(hdev->shdn_port, hdev->shdn_pin, GPIO_PIN_SET);
+        hdev->transport->Pin_Write(hdev, hdev->shdn_port, hdev->shdn_pin, 1);
     }
 
     /* 配置RS引脚 */
@@ -88,99 +751,770 @@ void AD840X_Config_Pins(AD840X_HandleTypeDef *hdev,
         hdev->rs_pin = rs_pin;
         
         /* 默认设置为高电平（正常工作模式） */
-        HAL_GPIO_WritePin(hdev->rs_port, hdev->rs_pin, GPIO_PIN_SET);
+        hdev->transport->Pin_Write(hdev, hdev->rs_port, hdev->rs_pin, 1);
     }
 }
 
 /**
- * @brief  AD840X写操作函数
+ * @brief  配置设备型号
  * @param  hdev: AD840X设备句柄指针
- * @param  channel: 通道地址（2位，见表13 Page22）
- * @param  value: 8位电阻值（0-255）
- * @note   - 如果初始化时检测到SPI配置了DMA，将自动使用DMA方式传输
- *         - 数据格式：Page11 Table6（10位：2位地址+8位数据）
- *         - 时序图：Page10 Figure3/Figure4
+ * @param  model: 器件型号（AD840X_MODEL_AD8400/AD8402/AD8403）
+ * @note   未调用时默认按AD8403（4通道）处理，与旧版本行为一致
+ * @note   配置后复位等批量操作只访问实际存在的通道
  * @retval None
  */
-void AD840X_Write(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value)
+void AD840X_Config_Model(AD840X_HandleTypeDef *hdev, AD840X_ModelTypeDef model)
 {
-    static uint8_t tx_data[2];
-    
-    /* 数据包构造（Table6 Page11）*/
-    tx_data[0] = channel; // 地址位在Bit9-Bit8（两位）
-    tx_data[1] = value;   // 数据位在Bit7-Bit0
-    
-    /* CS拉低（满足tCSS >10ns，Page10 Table4）*/
-    HAL_GPIO_WritePin(hdev->cs_port, hdev->cs_pin, GPIO_PIN_RESET);
-    
-    /* 根据初始化时检测到的DMA状态选择传输方式 */
-    if (hdev->use_dma)
-    {
-        /* 保存当前正在使用DMA的设备 */
-        current_dma_device = hdev;
-        
-        /* 使用DMA全局变量，确保传输过程中数据有效 */
-        tx_data_dma[0] = tx_data[0];
-        tx_data_dma[1] = tx_data[1];
-        
-        /* 使用DMA方式传输数据 */
-        HAL_SPI_Transmit_DMA(hdev->hspi, tx_data_dma, 2);
-        
-        /* 注意：CS引脚需要在传输完成回调函数中拉高 */
-        /* 这里不能直接拉高CS，因为DMA传输是异步的 */
-    }
-    else
-    {
-        /* 使用阻塞方式传输数据 */
-        HAL_SPI_Transmit(hdev->hspi, tx_data, 2, HAL_MAX_DELAY);
-        
-        /* CS拉高（满足tCSW >10ns，Page10 Table4）*/
-        HAL_GPIO_WritePin(hdev->cs_port, hdev->cs_pin, GPIO_PIN_SET);
-    }
+    hdev->model = model;
+    hdev->num_channels = (uint8_t)model; // 枚举值即通道数
 }
 
 /**
- * @brief  通过RS引脚复位所有通道到中间值
+ * @brief  配置回读校验写模式（仅AD8403）
  * @param  hdev: AD840X设备句柄指针
- * @note   时序需满足tRS≥50ns（Page10 Table4）
- * @note   如果RS引脚未连接到STM32，将通过SPI写入中间值实现复位
- * @ref    Page12 Pin Descriptions, Page20 Programming
+ * @param  enable: 1-启用，0-关闭
+ * @param  max_retries: 校验失败时的最大重试次数
+ * @note   需要SDO接到MISO并上拉4.7kΩ（Page22 Figure50），SPI必须是全双工
+ * @note   启用后写操作使用阻塞的全双工传输，不再使用DMA
+ * @retval None
  */
-void AD840X_Reset(AD840X_HandleTypeDef *hdev)
+void AD840X_Config_Verify(AD840X_HandleTypeDef *hdev, uint8_t enable, uint8_t max_retries)
 {
-    if (hdev->rs_port == NULL || hdev->rs_pin == PIN_NOT_CONNECTED)
+    /* 只有AD8403有SDO引脚，且传输后端必须能接收 */
+    if (hdev->model != AD840X_MODEL_AD8403 || hdev->transport->TransmitReceive == NULL)
     {
-        /* 引脚未连接时发出警告 */
-        #warning "RS pin not connected to STM32. Using SPI commands to reset to mid-scale. Make sure RS pin is pulled up to VDD externally."//RS引脚未连接STM32,请连接高电平。这里使用SPI设置为中值的方式复位
-        //SHDN和RS引脚不连接单片机时，请连接高电平
-        
-        /* 如果未连接RS引脚，则通过SPI写入中间值（128）到所有通道 */
-        AD840X_Write(hdev, AD840X_CHANNEL_1, 128);
-        AD840X_Write(hdev, AD840X_CHANNEL_2, 128);
-        AD840X_Write(hdev, AD840X_CHANNEL_3, 128);
-        AD840X_Write(hdev, AD840X_CHANNEL_4, 128);
+        enable = 0;
     }
-    else
+    /* GPIO模拟SPI没有配置SDO引脚时无法接收 */
+    if (hdev->transport == &AD840X_Transport_BitBang &&
+        ((const AD840X_BitBangTypeDef *)hdev->transport_ctx)->sdo_port == NULL)
     {
-        /* RS低脉冲触发复位 */
-        HAL_GPIO_WritePin(hdev->rs_port, hdev->rs_pin, GPIO_PIN_RESET);
-        // 短延时，确保至少50ns
-        for(volatile uint8_t i = 0; i < 5; i++); 
-        HAL_GPIO_WritePin(hdev->rs_port, hdev->rs_pin, GPIO_PIN_SET);
+        enable = 0;
+    }
+#if AD840X_POLICY != AD840X_POLICY_RUNTIME
+    enable = 0; // 写入路径编译时已固定，没有回读校验分支
+#endif
+#ifdef HAL_SPI_MODULE_ENABLED
+    if (hdev->hspi != NULL && hdev->hspi->Init.Direction != SPI_DIRECTION_2LINES)
+    {
+        enable = 0;
     }
+#endif
+
+    hdev->verify = enable;
+    hdev->verify_max_retries = max_retries;
+
+    /* 移位寄存器中的内容未知，第一帧不做比较 */
+    hdev->last_word_valid = 0;
 }
 
 /**
- * @brief  控制SHDN引脚进入/退出低功耗模式
+ * @brief  AD840X写操作函数
  * @param  hdev: AD840X设备句柄指针
- * @param  state: 0-进入断电模式，1-恢复正常模式
- * @note   仅AD8402/AD8403有效，AD8400需忽略此函数
- * @note   如果SHDN引脚未连接到STM32，此函数不会执行任何操作
- * @ref    Page12 Pin Descriptions, Page20 Theory of Operation
+ * @param  channel: 通道地址（2位，见表13 Page22）
+ * @param  value: 8位电阻值（0-255）
+ * @note   - 通道超出型号实际通道数时不发送任何数据
+ *         - 如果初始化时检测到SPI配置了DMA，将自动使用DMA方式传输：
+ *           帧进入总线队列后立即返回，队列满时等待
+ *         - 数据格式：Page11 Table6（10位：2位地址+8位数据）
+ *         - 时序图：Page10 Figure3/Figure4
+ * @retval None
  */
-void AD840X_Shutdown(AD840X_HandleTypeDef *hdev, uint8_t state)
+void AD840X_Write(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value)
 {
-    if (hdev->shdn_port == NULL || hdev->shdn_pin == PIN_NOT_CONNECTED)
+    (void)AD840X_WriteAsync(hdev, channel, value, NULL, NULL);
+}
+
+/**
+ * @brief  发送一帧，不记录写入值
+ * @param  hdev: AD840X设备句柄指针
+ * @param  channel: 通道地址（AD840X_CHANNEL_x）
+ * @param  value: 8位电阻值（0-255）
+ * @param  callback: 完成回调，不需要时传NULL
+ * @param  arg: 回调参数
+ * @retval 完成凭据
+ * @note   AD840X_Reset（SPI写中值）和AD840X_Restore直接使用，不改变shadow
+ */
+static AD840X_TokenTypeDef AD840X_Write_Frame(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value,
+                                              AD840X_CallbackTypeDef callback, void *arg)
+{
+    AD840X_TokenTypeDef token = {NULL, 0, HAL_OK, AD840X_PRIORITY_NORMAL};
+    uint8_t tx_data[2];
+
+    /* 该型号不存在此通道，写入无意义 */
+    if (channel >= hdev->num_channels)
+    {
+        token.status = HAL_ERROR;
+    }
+    else
+    {
+        /* 数据包构造（Table6 Page11）*/
+        tx_data[0] = channel; // 地址位在Bit9-Bit8（两位）
+        tx_data[1] = value;   // 数据位在Bit7-Bit0
+
+        /* 自动断电的器件先唤醒并等待稳定 */
+        AD840X_AutoShutdown_Touch(hdev);
+
+        /* 启用RTOS时整帧（或入队）期间占有总线，其他任务的CS帧不会插进来 */
+        AD840X_BUS_LOCK(hdev->bus);
+
+        /* 回读校验模式：全双工阻塞传输，同时比对上一帧 */
+        if (AD840X_PATH_VERIFY(hdev))
+        {
+            uint32_t trace = AD840X_TRACE(hdev, channel, value, AD840X_TRACE_VERIFY);
+
+            token.status = AD840X_Write_Verified(hdev, tx_data);
+            AD840X_TRACE_DONE(trace, token.status);
+            if (token.status == HAL_OK)
+            {
+                AD840X_TELEMETRY(hdev, channel, value);
+            }
+        }
+        /* 根据初始化时检测到的DMA状态选择传输方式 */
+        else if (AD840X_PATH_DMA(hdev))
+        {
+            /* 放入总线队列，CS在传输完成回调中拉高 */
+            /* 这里不能直接拉高CS，因为DMA传输是异步的 */
+            token.bus = hdev->bus;
+            token.seq = AD840X_Bus_Enqueue(hdev, tx_data, callback, arg);
+        }
+        else
+        {
+            uint32_t trace = AD840X_TRACE(hdev, channel, value, AD840X_TRACE_BLOCKING);
+
+            /* CS拉低（满足tCSS >10ns，Page10 Table4）*/
+            AD840X_SELECT(hdev, 1);
+
+            /* 使用传输后端阻塞发送数据 */
+            token.status = AD840X_TRANSMIT(hdev, tx_data, 2);
+
+            /* CS拉高（满足tCSW >10ns，Page10 Table4）*/
+            AD840X_SELECT(hdev, 0);
+            AD840X_TRACE_DONE(trace, token.status);
+            if (token.status == HAL_OK)
+            {
+                hdev->stats.frames++;
+                hdev->stats.bytes += 2U;
+                AD840X_TELEMETRY(hdev, channel, value);
+            }
+        }
+
+        /* 同步完成的帧（DMA帧在AD840X_Bus_Retire中处理） */
+        if (token.bus == NULL)
+        {
+            if (token.status != HAL_OK)
+            {
+                hdev->stats.errors++;
+            }
+            AD840X_Synced_Update(hdev, channel, value, token.status);
+        }
+
+        AD840X_BUS_UNLOCK(hdev->bus);
+    }
+
+    /* 同步完成的写入在这里通知 */
+    if (token.bus == NULL && callback != NULL)
+    {
+        callback(hdev, token.status, arg);
+    }
+    return token;
+}
+
+/**
+ * @brief  记录应用写入的值，供AD840X_Restore使用
+ * @param  hdev: AD840X设备句柄指针
+ * @param  channel: 通道地址
+ * @param  value: 8位电阻值
+ */
+static void AD840X_Shadow_Set(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value)
+{
+    if (channel < hdev->num_channels)
+    {
+        hdev->shadow[channel] = value;
+        hdev->shadow_valid |= (uint8_t)(1U << channel);
+        AD840X_Atomic_And(&hdev->synced, ~(1UL << channel)); // 帧成功锁存后由AD840X_Synced_Update置位
+    }
+}
+
+/**
+ * @brief  判断写入是否可以跳过
+ * @param  hdev: AD840X设备句柄指针
+ * @param  channel: 通道地址
+ * @param  value: 8位电阻值
+ * @retval 1-器件中已经是这个值，不必发送；0-需要发送
+ */
+static uint8_t AD840X_Skip_Redundant(const AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value)
+{
+    return hdev->skip_redundant && channel < hdev->num_channels && (hdev->synced & (1UL << channel)) &&
+           hdev->shadow[channel] == value;
+}
+
+/**
+ * @brief  推迟期间记录待补发的通道
+ * @param  hdev: AD840X设备句柄指针
+ * @param  channel: 通道地址
+ * @retval 1-已推迟，调用者不要访问总线；0-正常发送
+ */
+static uint8_t AD840X_Defer_Write(AD840X_HandleTypeDef *hdev, uint8_t channel)
+{
+    uint32_t primask;
+    uint8_t deferred = 0;
+
+    if (!ad840x_deferring || channel >= hdev->num_channels)
+    {
+        return 0;
+    }
+
+    /* 判断和置位之间不能插进AD840X_Defer_End，否则这一位要等到下一次推迟结束才发送 */
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if (ad840x_deferring)
+    {
+        hdev->deferred |= (uint8_t)(1U << channel);
+        deferred = 1;
+    }
+    __set_PRIMASK(primask);
+    return deferred;
+}
+
+/**
+ * @brief  写入前的记录：跳过重复值、更新shadow、推迟写入
+ * @param  hdev: AD840X设备句柄指针
+ * @param  channel: 通道地址（AD840X_CHANNEL_x）
+ * @param  value: 8位电阻值（0-255）
+ * @retval 1-需要发送，0-器件中已是这个值或已推迟到AD840X_Defer_End
+ */
+static uint8_t AD840X_Write_Prepare(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value)
+{
+    if (AD840X_Skip_Redundant(hdev, channel, value))
+    {
+        /* 器件中已经是这个值 */
+        hdev->stats.skipped++;
+        AD840X_TRACE_EVENT(hdev, channel, value, AD840X_TRACE_SKIPPED);
+        return 0;
+    }
+
+    AD840X_Shadow_Set(hdev, channel, value);
+    if (AD840X_Defer_Write(hdev, channel))
+    {
+        /* 值已记录，AD840X_Defer_End时发送 */
+        AD840X_TRACE_EVENT(hdev, channel, value, AD840X_TRACE_DEFERRED);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief  异步写入，返回完成凭据
+ * @param  hdev: AD840X设备句柄指针
+ * @param  channel: 通道地址（AD840X_CHANNEL_x）
+ * @param  value: 8位电阻值（0-255）
+ * @param  callback: 完成回调，不需要时传NULL
+ * @param  arg: 回调参数
+ * @retval 完成凭据，用AD840X_Token_Poll查询或AD840X_Token_Wait等待
+ * @note   DMA后端：帧入队后立即返回，回调在发送完成中断中调用；
+ *         其他后端或回读校验模式：同步完成，返回前在调用者上下文中调用回调
+ */
+AD840X_TokenTypeDef AD840X_WriteAsync(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value,
+                                      AD840X_CallbackTypeDef callback, void *arg)
+{
+    AD840X_TokenTypeDef token = {NULL, 0, HAL_OK, AD840X_PRIORITY_NORMAL};
+
+    if (!AD840X_Write_Prepare(hdev, channel, value))
+    {
+        if (callback != NULL)
+        {
+            callback(hdev, token.status, arg);
+        }
+        return token;
+    }
+    return AD840X_Write_Frame(hdev, channel, value, callback, arg);
+}
+
+/**
+ * @brief  高优先级写入，在下一个帧间隙插到所有普通帧之前发送
+ * @param  hdev: AD840X设备句柄指针
+ * @param  channel: 通道地址（AD840X_CHANNEL_x）
+ * @param  value: 8位电阻值（0-255）
+ * @param  flush: 1-同时取消队列中该设备该通道尚未发送的普通帧，0-不取消
+ * @param  callback: 完成回调，不需要时传NULL
+ * @param  arg: 回调参数
+ * @retval 完成凭据；高优先级队列已满时bus为NULL、status为HAL_ERROR
+ * @note   DMA后端可在中断中调用；其他后端或回读校验模式与AD840X_WriteAsync相同
+ */
+AD840X_TokenTypeDef AD840X_WriteUrgent(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value, uint8_t flush,
+                                       AD840X_CallbackTypeDef callback, void *arg)
+{
+    AD840X_TokenTypeDef token = {NULL, 0, HAL_ERROR, AD840X_PRIORITY_HIGH};
+    uint8_t tx_data[2];
+
+    /* 没有DMA队列时不存在排队，按普通写入处理 */
+    if (!AD840X_PATH_DMA(hdev) || AD840X_PATH_VERIFY(hdev) || ad840x_deferring)
+    {
+        return AD840X_WriteAsync(hdev, channel, value, callback, arg);
+    }
+    AD840X_Shadow_Set(hdev, channel, value);
+
+    if (channel < hdev->num_channels)
+    {
+        /* 数据包构造（Table6 Page11）*/
+        tx_data[0] = channel;
+        tx_data[1] = value;
+        AD840X_AutoShutdown_Touch(hdev);
+        if (AD840X_Bus_EnqueueUrgent(hdev, tx_data, flush, callback, arg, &token.seq))
+        {
+            token.bus = hdev->bus;
+            return token;
+        }
+    }
+
+    if (callback != NULL)
+    {
+        callback(hdev, token.status, arg);
+    }
+    return token;
+}
+
+/**
+ * @brief  查询异步写的结果
+ * @param  token: 完成凭据
+ * @retval HAL_BUSY-未完成，HAL_OK-已锁存，HAL_ERROR-传输出错
+ * @note   帧完成后，同一优先级队列再完成队列长度帧以内能查到出错状态，更早的帧只报告HAL_OK
+ */
+HAL_StatusTypeDef AD840X_Token_Poll(const AD840X_TokenTypeDef *token)
+{
+    const AD840X_LaneTypeDef *lane;
+    const AD840X_FrameTypeDef *frame;
+    HAL_StatusTypeDef status;
+
+    if (token->bus == NULL)
+    {
+        return token->status;
+    }
+    lane = &token->bus->lane[token->priority];
+
+    /* 序号按32位回绕比较 */
+    if ((int32_t)(lane->tail - token->seq) <= 0)
+    {
+        return HAL_BUSY;
+    }
+
+    __DMB(); // 读到tail后再读状态
+    frame = &lane->frames[token->seq & lane->mask];
+    status = (HAL_StatusTypeDef)frame->status;
+    if (frame->seq != token->seq || status == HAL_BUSY)
+    {
+        /* 槽位已被后面的帧复用 */
+        return HAL_OK;
+    }
+    return status;
+}
+
+/**
+ * @brief  等待异步写完成
+ * @param  token: 完成凭据
+ * @retval HAL_OK-已锁存，HAL_ERROR-传输出错
+ * @note   启用RTOS时阻塞在总线的完成信号量上，不要在中断或完成回调中调用
+ */
+HAL_StatusTypeDef AD840X_Token_Wait(const AD840X_TokenTypeDef *token)
+{
+    HAL_StatusTypeDef status = AD840X_Token_Poll(token);
+
+    if (status == HAL_BUSY)
+    {
+        AD840X_BUS_LOCK(token->bus); // 每条总线同一时刻只有一个任务等待完成信号量
+        while ((status = AD840X_Token_Poll(token)) == HAL_BUSY)
+        {
+            AD840X_BUS_WAIT(token->bus);
+        }
+        AD840X_BUS_UNLOCK(token->bus);
+    }
+    return status;
+}
+
+/**
+ * @brief  等待所有已注册总线的DMA队列发送完毕
+ */
+static void AD840X_Bus_WaitAll(void)
+{
+    for (uint8_t i = 0; i < AD840X_MAX_BUSES; i++)
+    {
+        if (ad840x_buses[i].id != NULL)
+        {
+            /* 每条总线同一时刻只有一个任务等待完成信号量 */
+            AD840X_BUS_LOCK(&ad840x_buses[i]);
+            AD840X_Bus_WaitIdle(&ad840x_buses[i]);
+            AD840X_BUS_UNLOCK(&ad840x_buses[i]);
+        }
+    }
+}
+
+/**
+ * @brief  批量写入，多条SPI总线上的命令同时发送
+ * @param  cmds: 命令数组
+ * @param  count: 命令数量
+ * @note   DMA总线上的命令进入各自的队列后立即返回，两条总线的DMA同时工作；
+ *         阻塞总线上的命令在DMA后台传输期间依次发送
+ * @note   函数在所有命令发送完成后返回
+ * @retval None
+ */
+void AD840X_WriteBatch(const AD840X_CommandTypeDef *cmds, uint16_t count)
+{
+    for (uint16_t i = 0; i < count; i++)
+    {
+        AD840X_Write(cmds[i].hdev, cmds[i].channel, cmds[i].value);
+    }
+
+    AD840X_Bus_WaitAll();
+}
+
+/**
+ * @brief  等待设备所在总线上的DMA队列发送完毕
+ * @param  hdev: AD840X设备句柄指针
+ * @retval None
+ */
+void AD840X_WaitIdle(AD840X_HandleTypeDef *hdev)
+{
+    if (hdev->bus != NULL)
+    {
+        AD840X_BUS_LOCK(hdev->bus); // 每条总线同一时刻只有一个任务等待完成信号量
+        AD840X_Bus_WaitIdle(hdev->bus);
+        AD840X_BUS_UNLOCK(hdev->bus);
+    }
+}
+
+/**
+ * @brief  把各设备最后写入的值重新写回器件（RS复位、掉电重启后恢复状态）
+ * @param  devs: 设备句柄指针数组
+ * @param  count: 设备数量
+ * @param  from_midscale: 1-器件处于中值，跳过值为中值的通道；0-所有写过的通道都重发
+ * @param  frames: 返回实际发送的帧数，不需要时传NULL
+ * @retval 恢复耗时（μs）
+ */
+uint32_t AD840X_Restore(AD840X_HandleTypeDef *const *devs, uint8_t count, uint8_t from_midscale,
+                        uint16_t *frames)
+{
+    uint32_t start = AD840X_Time_Now();
+    uint16_t sent = 0;
+
+    /* 先把所有帧放进各总线的队列，多条总线的DMA同时工作 */
+    for (uint8_t i = 0; i < count; i++)
+    {
+        AD840X_HandleTypeDef *hdev = devs[i];
+
+        if (from_midscale)
+        {
+            /* 复位或上电后移位寄存器内容未知，第一帧不做回读比较 */
+            hdev->last_word_valid = 0;
+        }
+
+        for (uint8_t channel = 0; channel < hdev->num_channels; channel++)
+        {
+            if (!(hdev->shadow_valid & (1U << channel)))
+            {
+                continue;
+            }
+            if (from_midscale && hdev->shadow[channel] == AD840X_MIDSCALE)
+            {
+                AD840X_Atomic_Or(&hdev->synced, 1UL << channel); // 复位后器件中已是中值
+                continue;
+            }
+            (void)AD840X_Write_Frame(hdev, channel, hdev->shadow[channel], NULL, NULL);
+            sent++;
+        }
+    }
+
+    AD840X_Bus_WaitAll();
+
+    if (frames != NULL)
+    {
+        *frames = sent;
+    }
+    return AD840X_Time_ToUs(AD840X_Time_Now() - start);
+}
+
+#ifdef HAL_SPI_MODULE_ENABLED
+/**
+ * @brief  SPI发送完成回调，DMA模式下必须调用
+ * @param  hspi: SPI句柄指针
+ * @note   在HAL_SPI_TxCpltCallback中调用，负责拉高CS并启动队列中的下一帧
+ * @retval None
+ */
+void AD840X_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    AD840X_Transport_TxComplete(hspi);
+}
+#endif
+
+/**
+ * @brief  传输后端的异步发送完成通知
+ * @param  bus_id: 总线标识（设备的transport_ctx）
+ * @note   在中断上下文中调用，负责拉高CS并启动队列中的下一帧
+ * @retval None
+ */
+void AD840X_Transport_TxComplete(void *bus_id)
+{
+    AD840X_BusTypeDef *bus = AD840X_Bus_Find(bus_id);
+
+    if (bus != NULL && bus->busy)
+    {
+        AD840X_Bus_FrameDone(bus, HAL_OK);
+    }
+}
+
+/**
+ * @brief  传输后端的异步发送出错通知
+ * @param  bus_id: 总线标识（设备的transport_ctx）
+ * @note   在出错中断中调用，丢弃当前帧（完成状态为HAL_ERROR）并启动队列中的下一帧
+ * @retval None
+ */
+void AD840X_Transport_TxError(void *bus_id)
+{
+    AD840X_BusTypeDef *bus = AD840X_Bus_Find(bus_id);
+
+    if (bus != NULL && bus->busy)
+    {
+        AD840X_Bus_FrameDone(bus, HAL_ERROR);
+    }
+}
+
+/**
+ * @brief  自己驱动CS和数据线的后端（例如多通道并行GPIO）在发送前调用
+ * @param  hdev: AD840X设备句柄指针
+ * @param  channel: 通道地址（由调用者保证小于num_channels）
+ * @param  value: 8位电阻值（0-255）
+ * @param  trace: 输出，跟踪记录序号，交给AD840X_Transport_WriteEnd
+ * @retval 1-需要发送，0-跳过（重复值或推迟写入，与AD840X_WriteAsync相同）
+ * @note   更新shadow；需要发送时会唤醒自动断电的器件
+ */
+uint8_t AD840X_Transport_WriteBegin(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value, uint32_t *trace)
+{
+    if (!AD840X_Write_Prepare(hdev, channel, value))
+    {
+        return 0;
+    }
+    AD840X_AutoShutdown_Touch(hdev);
+    *trace = AD840X_TRACE(hdev, channel, value, AD840X_TRACE_BLOCKING);
+    return 1;
+}
+
+/**
+ * @brief  帧锁存（CS拉高）之后调用，更新统计、同步状态和跟踪记录
+ * @param  hdev: AD840X设备句柄指针
+ * @param  channel: 通道地址
+ * @param  value: 8位电阻值（0-255）
+ * @param  status: 传输结果
+ * @param  trace: AD840X_Transport_WriteBegin输出的跟踪记录序号
+ * @retval None
+ */
+void AD840X_Transport_WriteEnd(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value,
+                               HAL_StatusTypeDef status, uint32_t trace)
+{
+    AD840X_TRACE_DONE(trace, status);
+    if (status == HAL_OK)
+    {
+        hdev->stats.frames++;
+        hdev->stats.bytes += 2U;
+        AD840X_TELEMETRY(hdev, channel, value);
+    }
+    else
+    {
+        hdev->stats.errors++;
+    }
+    AD840X_Synced_Update(hdev, channel, value, status);
+}
+
+/**
+ * @brief  占有设备所在的总线（启用RTOS时），与AD840X_Transport_Unlock成对使用
+ * @param  hdev: AD840X设备句柄指针
+ * @retval None
+ */
+void AD840X_Transport_Lock(AD840X_HandleTypeDef *hdev)
+{
+    (void)hdev; // 裸机时总线锁为空
+    AD840X_BUS_LOCK(hdev->bus);
+}
+
+/**
+ * @brief  释放AD840X_Transport_Lock占有的总线
+ * @param  hdev: AD840X设备句柄指针
+ * @retval None
+ */
+void AD840X_Transport_Unlock(AD840X_HandleTypeDef *hdev)
+{
+    (void)hdev; // 裸机时总线锁为空
+    AD840X_BUS_UNLOCK(hdev->bus);
+}
+
+#ifdef HAL_SPI_MODULE_ENABLED
+/**
+ * @brief  SPI错误回调，DMA模式下建议调用
+ * @param  hspi: SPI句柄指针
+ * @note   在HAL_SPI_ErrorCallback中调用，丢弃出错的帧并继续发送队列
+ * @retval None
+ */
+void AD840X_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+    AD840X_Transport_TxError(hspi);
+}
+
+/**
+ * @brief  获取SPI当前的SCK频率
+ * @param  hspi: SPI句柄指针
+ * @retval SCK频率（Hz）
+ */
+uint32_t AD840X_SPI_GetClock(SPI_HandleTypeDef *hspi)
+{
+    uint32_t br = (READ_REG(hspi->Instance->CR1) & SPI_CR1_BR) >> SPI_CR1_BR_Pos;
+
+    return AD840X_SPI_GetPCLK(hspi) >> (br + 1U);
+}
+
+/**
+ * @brief  根据当前PCLK选择不超过上限的最快SPI分频系数
+ * @param  hspi: SPI句柄指针
+ * @param  max_hz: 允许的最高SCK频率，一般传AD840X_SPI_MAX_CLOCK_HZ
+ * @retval 实际的SCK频率（Hz）
+ * @note   时钟配置改变后（例如SystemClock_Config之后）需要重新调用
+ */
+uint32_t AD840X_SPI_PlanClock(SPI_HandleTypeDef *hspi, uint32_t max_hz)
+{
+    uint32_t pclk = AD840X_SPI_GetPCLK(hspi);
+    uint32_t br = 0;
+
+    /* 从2分频开始，找到第一个不超过上限的分频系数，最大256分频 */
+    while (br < 7U && (pclk >> (br + 1U)) > max_hz)
+    {
+        br++;
+    }
+
+    AD840X_SPI_SetPrescaler(hspi, br);
+    return pclk >> (br + 1U);
+}
+
+/**
+ * @brief  通过SDO回读探测超出手册规格的最高可用SPI时钟（仅AD8403）
+ * @param  hdev: AD840X设备句柄指针
+ * @param  channel: 探测时用于写入测试数据的通道
+ * @param  restore_value: 探测结束后写回该通道的值
+ * @retval 最终采用的SCK频率（Hz）
+ * @note   从当前分频系数开始逐级加快，每级写入一组测试数据并做回读比对，
+ *         出现错误即退回上一级。回读路径包含SDO传播延迟（Page10 Table4 tPD），
+ *         比写入路径更苛刻，因此结果偏保守
+ * @note   超出10MHz属于超规格使用，只建议在短线、低噪声的板子上使用
+ */
+uint32_t AD840X_SPI_ProbeClock(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t restore_value)
+{
+    static const uint8_t patterns[] = {0x55, 0xAA, 0x00, 0xFF, 0x5A, 0xA5};
+    SPI_HandleTypeDef *hspi = hdev->hspi;
+    uint8_t saved_verify = hdev->verify;
+    uint8_t saved_retries = hdev->verify_max_retries;
+    uint8_t saved_skip = hdev->skip_redundant;
+    uint32_t br;
+    uint32_t errors;
+
+    if (hspi == NULL)
+    {
+        /* 不是HAL SPI后端，无法调整分频 */
+        return 0;
+    }
+    br = (READ_REG(hspi->Instance->CR1) & SPI_CR1_BR) >> SPI_CR1_BR_Pos;
+
+    /* 每一级都要真正写出测试数据 */
+    hdev->skip_redundant = 0;
+    AD840X_Config_Verify(hdev, 1, 0);
+    if (!hdev->verify)
+    {
+        /* 不是AD8403或SPI不能接收，无法探测 */
+        AD840X_Config_Verify(hdev, saved_verify, saved_retries);
+        hdev->skip_redundant = saved_skip;
+        return AD840X_SPI_GetClock(hspi);
+    }
+
+    while (br > 0U)
+    {
+        AD840X_SPI_SetPrescaler(hspi, br - 1U);
+        hdev->last_word_valid = 0;
+        errors = hdev->verify_errors;
+
+        for (uint8_t i = 0; i < sizeof(patterns); i++)
+        {
+            AD840X_Write(hdev, channel, patterns[i]);
+        }
+        AD840X_Write(hdev, channel, restore_value); // 最后一帧用于校验最后一个测试数据
+
+        if (hdev->verify_errors != errors)
+        {
+            /* 这一级不可靠，退回上一级 */
+            hdev->verify_errors = errors;
+            AD840X_SPI_SetPrescaler(hspi, br);
+            break;
+        }
+        br--;
+    }
+
+    /* 在最终时钟下重新写入，保证通道值正确 */
+    AD840X_Write(hdev, channel, restore_value);
+    AD840X_Config_Verify(hdev, saved_verify, saved_retries);
+    hdev->skip_redundant = saved_skip;
+
+    return AD840X_SPI_GetClock(hspi);
+}
+#endif
+
+/**
+ * @brief  通过RS引脚复位所有通道到中间值
+ * @param  hdev: AD840X设备句柄指针
+ * @note   时序需满足tRS≥50ns（Page10 Table4）
+ * @note   如果RS引脚未连接到STM32，将通过SPI向型号实际存在的通道写入中间值实现复位
+ * @ref    Page12 Pin Descriptions, Page20 Programming
+ */
+void AD840X_Reset(AD840X_HandleTypeDef *hdev)
+{
+    /* 器件回到中值，与shadow不再一致 */
+    AD840X_Atomic_And(&hdev->synced, 0UL);
+
+    if (hdev->rs_port == NULL || hdev->rs_pin == PIN_NOT_CONNECTED)
+    {
+        /* 引脚未连接时发出警告 */
+        #warning "RS pin not connected to STM32. Using SPI commands to reset to mid-scale. Make sure RS pin is pulled up to VDD externally."//RS引脚未连接STM32,请连接高电平。这里使用SPI设置为中值的方式复位
+        //SHDN和RS引脚不连接单片机时，请连接高电平
+        
+        /* 如果未连接RS引脚，则通过SPI写入中间值（128）到型号实际存在的通道 */
+        for (uint8_t channel = 0; channel < hdev->num_channels; channel++)
+        {
+            (void)AD840X_Write_Frame(hdev, channel, AD840X_MIDSCALE, NULL, NULL);
+        }
+    }
+    else
+    {
+        /* RS低脉冲触发复位 */
+        hdev->transport->Pin_Write(hdev, hdev->rs_port, hdev->rs_pin, 0);
+        // 短延时，确保至少50ns
+        hdev->transport->Delay(hdev, AD840X_T_RS_NS);
+        hdev->transport->Pin_Write(hdev, hdev->rs_port, hdev->rs_pin, 1);
+
+        /* 复位后移位寄存器内容不再可信，下一帧不做回读比较 */
+        hdev->last_word_valid = 0;
+
+        for (uint8_t channel = 0; channel < hdev->num_channels; channel++)
+        {
+            AD840X_TELEMETRY(hdev, channel, AD840X_MIDSCALE);
+        }
+    }
+}
+
+/**
+ * @brief  控制SHDN引脚进入/退出低功耗模式
+ * @param  hdev: AD840X设备句柄指针
+ * @param  state: 0-进入断电模式，1-恢复正常模式
+ * @note   仅AD8402/AD8403有效，AD8400需忽略此函数
+ * @note   如果SHDN引脚未连接到STM32，此函数不会执行任何操作
+ * @ref    Page12 Pin Descriptions, Page20 Theory of Operation
+ */
+void AD840X_Shutdown(AD840X_HandleTypeDef *hdev, uint8_t state)
+{
+    if (hdev->shdn_port == NULL || hdev->shdn_pin == PIN_NOT_CONNECTED)
     {
         /* 引脚未连接时发出警告 */
         #warning "SHDN pin not connected to STM32. Cannot control shutdown mode. Make sure SHDN pin is pulled up to VDD externally for normal operation."//SHDN引脚不连接单片机时,这个函数无效
@@ -189,14 +1523,228 @@ void AD840X_Shutdown(AD840X_HandleTypeDef *hdev, uint8_t state)
     }
 
     /* SHDN低电平有效 */
-    HAL_GPIO_WritePin(hdev->shdn_port, hdev->shdn_pin,
-                     state ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    hdev->transport->Pin_Write(hdev, hdev->shdn_port, hdev->shdn_pin, state ? 1 : 0);
+    if (state && hdev->powered_down)
+    {
+        hdev->stats.shutdown_ms += HAL_GetTick() - hdev->idle_since;
+    }
+    hdev->powered_down = state ? 0 : 1;
+    hdev->idle_since = HAL_GetTick(); // 断电期间记录断电开始的时刻
 
     /* 退出断电模式后需等待稳定（参考Page4 Table1的ts参数）*/
     if (state)
     {
-        HAL_Delay(1); // 至少等待2μs（根据ts=2μs@10kΩ）
+        hdev->transport->Delay(hdev, AD840X_T_SETTLE_NS); // 至少等待2μs（根据ts=2μs@10kΩ）
+    }
+}
+
+/**
+ * @brief  配置空闲自动断电
+ * @param  hdev: AD840X设备句柄指针
+ * @param  idle_ms: 距最后一次写入超过该时间后进入断电模式，0表示关闭
+ * @note   需要SHDN引脚接到STM32，否则不启用
+ * @retval None
+ */
+void AD840X_Config_AutoShutdown(AD840X_HandleTypeDef *hdev, uint32_t idle_ms)
+{
+    if (hdev->shdn_port == NULL || hdev->shdn_pin == PIN_NOT_CONNECTED)
+    {
+        idle_ms = 0;
+    }
+
+    hdev->idle_since = HAL_GetTick();
+    hdev->auto_shdn_ms = idle_ms;
+}
+
+/**
+ * @brief  让空闲超时的器件进入断电模式
+ * @param  devs: 设备句柄指针数组
+ * @param  count: 设备数量
+ * @note   在主循环或周期任务中调用
+ * @retval 本次进入断电模式的器件数
+ */
+uint8_t AD840X_AutoShutdown_Process(AD840X_HandleTypeDef *const *devs, uint8_t count)
+{
+    uint8_t entered = 0;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        AD840X_HandleTypeDef *hdev = devs[i];
+        uint32_t primask;
+
+        if (hdev->auto_shdn_ms == 0U || hdev->powered_down)
+        {
+            continue;
+        }
+
+        /* 判断和拉低SHDN之间不能插进写入（AD840X_AutoShutdown_Touch），否则新值会写到断电的器件上 */
+        primask = __get_PRIMASK();
+        __disable_irq();
+        if (!hdev->powered_down && HAL_GetTick() - hdev->idle_since >= hdev->auto_shdn_ms)
+        {
+            /* SHDN低电平：A端开路，电阻串不再消耗电流；数字接口仍然工作（Page12 Pin Descriptions）*/
+            hdev->transport->Pin_Write(hdev, hdev->shdn_port, hdev->shdn_pin, 0);
+            hdev->powered_down = 1;
+            hdev->idle_since = HAL_GetTick(); // 断电期间记录断电开始的时刻
+            entered++;
+        }
+        __set_PRIMASK(primask);
+    }
+    return entered;
+}
+
+/**
+ * @brief  写入前调用：刷新空闲计时，器件已自动断电时先唤醒
+ * @param  hdev: AD840X设备句柄指针
+ * @note   可在中断中调用；唤醒时忙等ts
+ * @retval None
+ */
+void AD840X_AutoShutdown_Touch(AD840X_HandleTypeDef *hdev)
+{
+    uint32_t primask;
+    uint8_t wake = 0;
+
+    if (hdev->auto_shdn_ms == 0U)
+    {
+        return;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if (hdev->powered_down)
+    {
+        hdev->stats.shutdown_ms += HAL_GetTick() - hdev->idle_since;
+        hdev->transport->Pin_Write(hdev, hdev->shdn_port, hdev->shdn_pin, 1);
+        hdev->powered_down = 0;
+        hdev->wakeups++;
+        wake = 1;
+    }
+    hdev->idle_since = HAL_GetTick();
+    __set_PRIMASK(primask);
+
+    /* 退出断电模式后等待稳定再写入（Page4 Table1的ts参数），不在临界区内等待 */
+    if (wake)
+    {
+        hdev->transport->Delay(hdev, AD840X_T_SETTLE_NS);
+    }
+}
+
+/**
+ * @brief  配置是否跳过重复写入
+ * @param  hdev: AD840X设备句柄指针
+ * @param  enable: 1-写入值与器件中已有的值相同时不发送，0-每次都发送
+ * @retval None
+ */
+void AD840X_Config_SkipRedundant(AD840X_HandleTypeDef *hdev, uint8_t enable)
+{
+    hdev->skip_redundant = enable ? 1 : 0;
+}
+
+/**
+ * @brief  读取设备运行统计
+ * @param  hdev: AD840X设备句柄指针
+ * @param  stats: 返回统计快照
+ * @retval None
+ */
+void AD840X_GetStats(AD840X_HandleTypeDef *hdev, AD840X_StatsTypeDef *stats)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    /* 计数器在DMA完成中断中也会累加，关中断复制保证快照一致 */
+    __disable_irq();
+    *stats = hdev->stats;
+    if (hdev->powered_down)
+    {
+        stats->shutdown_ms += HAL_GetTick() - hdev->idle_since;
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief  读取设备所在总线的运行统计
+ * @param  hdev: AD840X设备句柄指针
+ * @param  stats: 返回统计快照
+ * @retval HAL_OK-成功，HAL_ERROR-设备没有注册总线
+ */
+HAL_StatusTypeDef AD840X_GetBusStats(AD840X_HandleTypeDef *hdev, AD840X_BusStatsTypeDef *stats)
+{
+    AD840X_BusTypeDef *bus = hdev->bus;
+    uint64_t cycles;
+    uint32_t primask;
+
+    if (bus == NULL)
+    {
+        return HAL_ERROR;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    stats->frames = bus->frames;
+    stats->waits = bus->waits;
+    stats->errors = bus->errors;
+    stats->flushed = bus->flushed;
+    stats->urgent_wait_max = bus->urgent_wait_max;
+    cycles = bus->busy_cycles;
+    if (bus->busy)
+    {
+        cycles += AD840X_Time_Now() - bus->busy_since;
+    }
+    __set_PRIMASK(primask);
+
+    /* 64位除法只在读取时做一次 */
+    stats->busy_us = (uint32_t)(cycles / (AD840X_TIME_HZ / 1000000U));
+    return HAL_OK;
+}
+
+/**
+ * @brief  开始推迟写入：此后的写入只记录到shadow，不访问总线，并等待所有总线队列发送完毕
+ * @note   不要在中断中调用
+ * @retval None
+ */
+void AD840X_Defer_Begin(void)
+{
+    ad840x_deferring = 1;
+    __DMB(); // 置位先于等待，之后入队的帧只可能来自置位前已开始的写入
+
+    /* 不让帧停在半途：STOP模式下SCK停止，CS会一直保持低电平 */
+    AD840X_Bus_WaitAll();
+}
+
+/**
+ * @brief  结束推迟写入，发送推迟期间写入过的通道（每通道只发最后一次的值）
+ * @param  devs: 设备句柄指针数组
+ * @param  count: 设备数量
+ * @retval 补发的帧数
+ */
+uint16_t AD840X_Defer_End(AD840X_HandleTypeDef *const *devs, uint8_t count)
+{
+    uint16_t frames = 0;
+    uint32_t primask;
+
+    ad840x_deferring = 0;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        AD840X_HandleTypeDef *hdev = devs[i];
+        uint8_t pending;
+
+        /* 取走标志后再读shadow，期间中断里的新写入直接发送，不会丢失 */
+        primask = __get_PRIMASK();
+        __disable_irq();
+        pending = hdev->deferred;
+        hdev->deferred = 0;
+        __set_PRIMASK(primask);
+
+        for (uint8_t channel = 0; pending != 0U; channel++, pending >>= 1)
+        {
+            if (pending & 1U)
+            {
+                (void)AD840X_Write_Frame(hdev, channel, *(volatile uint8_t *)&hdev->shadow[channel], NULL, NULL);
+                frames++;
+            }
+        }
     }
+    return frames;
 }
 
 /**
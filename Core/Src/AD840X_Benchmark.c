@@ -0,0 +1,245 @@
+/*
+ * AD840X系列数字电位器驱动库 - 板上基准测试
+ * 雪豹  编写
+ */
+#include "AD840X_Benchmark.h"
+
+#ifdef AD840X_BENCHMARK
+
+#include <stdio.h>
+#include "spi.h"
+#include "AD840X_Transport.h"
+#include "AD840X_Transport_LL.h"
+#include "AD840X_Time.h"
+
+/* 结果输出 */
+#ifndef AD840X_BENCHMARK_PUTS
+#ifdef AD840X_BENCHMARK_SEMIHOSTING
+#define AD840X_BENCHMARK_PUTS(line) AD840X_Bench_Semihost(line)
+#else
+#define AD840X_BENCHMARK_PUTS(line) AD840X_Bench_ITM(line)
+#endif
+#endif
+
+#define AD840X_BENCH_DEVICES 3
+
+/* 固定写入路径（AD840X_POLICY）时只运行该路径支持的后端 */
+#define AD840X_BENCH_OPS (AD840X_POLICY == AD840X_POLICY_RUNTIME || AD840X_POLICY == AD840X_POLICY_BLOCKING)
+#define AD840X_BENCH_REG (AD840X_POLICY != AD840X_POLICY_DMA)
+#define AD840X_BENCH_DMA (AD840X_POLICY == AD840X_POLICY_RUNTIME || AD840X_POLICY == AD840X_POLICY_DMA)
+
+#if AD840X_POLICY == AD840X_POLICY_BLOCKING
+#define AD840X_BENCH_POLICY "blocking"
+#elif AD840X_POLICY == AD840X_POLICY_REG
+#define AD840X_BENCH_POLICY "reg"
+#elif AD840X_POLICY == AD840X_POLICY_DMA
+#define AD840X_BENCH_POLICY "dma"
+#else
+#define AD840X_BENCH_POLICY "runtime"
+#endif
+
+/* 一个传输后端 */
+typedef struct
+{
+    const char *name;                          // 输出中的名称
+    const AD840X_TransportTypeDef *transport;  // 操作表
+    void *ctx;                                 // transport_ctx
+    void (*enter)(void);                       // 场景开始前的准备，不需要时为NULL
+    void (*leave)(void);                       // 场景结束后的恢复，不需要时为NULL
+} AD840X_BenchBackendTypeDef;
+
+static AD840X_HandleTypeDef bench_dev[AD840X_BENCH_DEVICES];
+static AD840X_CommandTypeDef bench_cmds[16];
+#if AD840X_BENCH_OPS
+static AD840X_LLTypeDef bench_ll;
+static const AD840X_BitBangTypeDef bench_bitbang = {GPIOA, GPIO_PIN_5, GPIOA, GPIO_PIN_7, NULL, 0};
+#endif
+#if AD840X_BENCH_DMA
+static AD840X_LLTypeDef bench_ll_dma;
+#endif
+
+static GPIO_TypeDef *const bench_cs_port[AD840X_BENCH_DEVICES] = {AD840X_CS1_GPIO_Port, AD840X_CS2_GPIO_Port,
+                                                                  AD840X_CS3_GPIO_Port};
+static const uint16_t bench_cs_pin[AD840X_BENCH_DEVICES] = {AD840X_CS1_Pin, AD840X_CS2_Pin, AD840X_CS3_Pin};
+static const uint8_t bench_batches[] = {1, 4, 16};
+
+#ifdef AD840X_BENCHMARK_SEMIHOSTING
+/**
+ * @brief  半主机SYS_WRITE0输出一个字符串
+ * @param  line: 以'\0'结尾的字符串
+ */
+static void AD840X_Bench_Semihost(const char *line)
+{
+    register uint32_t r0 __asm("r0") = 0x04U; // SYS_WRITE0
+    register const char *r1 __asm("r1") = line;
+
+    __asm volatile("bkpt 0xAB" : "+r"(r0) : "r"(r1) : "memory");
+}
+#else
+/**
+ * @brief  从ITM端口0输出一个字符串
+ * @param  line: 以'\0'结尾的字符串
+ * @note   调试器没有打开SWO时ITM_SendChar直接返回
+ */
+static void AD840X_Bench_ITM(const char *line)
+{
+    while (*line != '\0')
+    {
+        (void)ITM_SendChar((uint32_t)*line++);
+    }
+}
+#endif
+
+#if AD840X_BENCH_OPS
+/**
+ * @brief  把SPI1的SCK、MOSI切换为普通GPIO输出，给GPIO模拟SPI使用
+ */
+static void AD840X_Bench_BitBangEnter(void)
+{
+    GPIO_InitTypeDef gpio = {GPIO_PIN_5 | GPIO_PIN_7, GPIO_MODE_OUTPUT_PP, GPIO_NOPULL, GPIO_SPEED_FREQ_HIGH};
+
+    HAL_GPIO_WritePin(GPIOA, GPIO_PIN_5 | GPIO_PIN_7, GPIO_PIN_RESET); // Mode 0：SCK空闲为低
+    HAL_GPIO_Init(GPIOA, &gpio);
+}
+
+/**
+ * @brief  把SCK、MOSI恢复为SPI1复用功能（与HAL_SPI_MspInit相同）
+ */
+static void AD840X_Bench_BitBangLeave(void)
+{
+    GPIO_InitTypeDef gpio = {GPIO_PIN_5 | GPIO_PIN_7, GPIO_MODE_AF_PP, GPIO_NOPULL, GPIO_SPEED_FREQ_HIGH};
+
+    HAL_GPIO_Init(GPIOA, &gpio);
+}
+#endif
+
+#if AD840X_BENCH_DMA
+/**
+ * @brief  打开DMA1时钟和Channel3中断，LL后端使用DMA发送
+ */
+static void AD840X_Bench_DMAEnter(void)
+{
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    HAL_NVIC_SetPriority(DMA1_Channel3_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel3_IRQn);
+    AD840X_LL_Init(&bench_ll_dma, SPI1, DMA1, LL_DMA_CHANNEL_3);
+}
+
+/**
+ * @brief  SPI1_TX（DMA1 Channel3）传输完成中断
+ */
+void DMA1_Channel3_IRQHandler(void)
+{
+    AD840X_LL_DMA_IRQHandler(&bench_ll_dma);
+}
+#endif
+
+static const AD840X_BenchBackendTypeDef bench_backends[] = {
+#if AD840X_BENCH_OPS
+    {"hal", &AD840X_Transport_HAL, &hspi1, NULL, NULL},
+#endif
+#if AD840X_BENCH_REG
+    {"reg", &AD840X_Transport_Reg, SPI1, NULL, NULL},
+#endif
+#if AD840X_BENCH_OPS
+    {"ll", &AD840X_Transport_LL, &bench_ll, NULL, NULL},
+    {"bitbang", &AD840X_Transport_BitBang, (void *)&bench_bitbang, AD840X_Bench_BitBangEnter,
+     AD840X_Bench_BitBangLeave},
+#endif
+#if AD840X_BENCH_DMA
+    {"ll_dma", &AD840X_Transport_LL_DMA, &bench_ll_dma, AD840X_Bench_DMAEnter, NULL}, // 最后运行，见头文件
+#endif
+};
+
+/**
+ * @brief  运行一个场景
+ * @param  backend: 传输后端
+ * @param  devices: 设备数
+ * @param  batch: 每批帧数
+ * @retval 总周期数
+ */
+static uint32_t AD840X_Bench_Scenario(const AD840X_BenchBackendTypeDef *backend, uint8_t devices, uint8_t batch)
+{
+    uint32_t start;
+    uint8_t value = 0;
+
+    for (uint8_t i = 0; i < devices; i++)
+    {
+        AD840X_Init_Transport(&bench_dev[i], backend->transport, backend->ctx, bench_cs_port[i], bench_cs_pin[i]);
+    }
+
+    /* 设备轮流写，每台设备的4个通道轮流写 */
+    for (uint8_t k = 0; k < 16U; k++)
+    {
+        bench_cmds[k].hdev = &bench_dev[k % devices];
+        bench_cmds[k].channel = (uint8_t)((k / devices) & 0x03U);
+    }
+
+    /* 先跑一批，让SPI使能、总线注册等一次性开销不计入结果 */
+    AD840X_WriteBatch(bench_cmds, batch);
+
+    start = AD840X_Time_Now();
+    for (uint32_t n = 0; n < AD840X_BENCHMARK_WRITES; n += batch)
+    {
+        for (uint8_t k = 0; k < batch; k++)
+        {
+            bench_cmds[k].value = value++;
+        }
+        AD840X_WriteBatch(bench_cmds, batch);
+    }
+    return AD840X_Time_Now() - start;
+}
+
+/**
+ * @brief  依次运行所有基准测试场景并输出结果
+ * @retval None
+ */
+void AD840X_Benchmark_Run(void)
+{
+    char line[96];
+    uint32_t sck;
+
+    /* 两台带RS/SHDN的设备保持在正常工作状态 */
+    HAL_GPIO_WritePin(GPIOB, AD840X_RS1_Pin | AD840X_SHDN1_Pin | AD840X_RS2_Pin | AD840X_SHDN2_Pin, GPIO_PIN_SET);
+
+    /* 分频写入SPI1的CR1，寄存器和LL后端直接沿用 */
+    sck = AD840X_SPI_PlanClock(&hspi1, AD840X_SPI_MAX_CLOCK_HZ);
+    AD840X_Time_Init();
+#if AD840X_BENCH_OPS
+    AD840X_LL_Init(&bench_ll, SPI1, NULL, 0);
+#endif
+    snprintf(line, sizeof(line), "# AD840X benchmark: policy %s, SYSCLK %lu Hz, SCK %lu Hz\n", AD840X_BENCH_POLICY,
+             (unsigned long)SystemCoreClock, (unsigned long)sck);
+    AD840X_BENCHMARK_PUTS(line);
+    AD840X_BENCHMARK_PUTS("backend,devices,batch,writes,cycles_per_write,writes_per_s\n");
+
+    for (uint8_t b = 0; b < sizeof(bench_backends) / sizeof(bench_backends[0]); b++)
+    {
+        const AD840X_BenchBackendTypeDef *backend = &bench_backends[b];
+
+        if (backend->enter != NULL)
+        {
+            backend->enter();
+        }
+        for (uint8_t devices = 1; devices <= AD840X_BENCH_DEVICES; devices++)
+        {
+            for (uint8_t i = 0; i < sizeof(bench_batches); i++)
+            {
+                uint32_t cycles = AD840X_Bench_Scenario(backend, devices, bench_batches[i]);
+
+                snprintf(line, sizeof(line), "%s,%u,%u,%u,%lu.%lu,%lu\n", backend->name, devices, bench_batches[i],
+                         AD840X_BENCHMARK_WRITES, (unsigned long)(cycles / AD840X_BENCHMARK_WRITES),
+                         (unsigned long)(cycles % AD840X_BENCHMARK_WRITES * 10U / AD840X_BENCHMARK_WRITES),
+                         (unsigned long)((uint64_t)SystemCoreClock * AD840X_BENCHMARK_WRITES / cycles));
+                AD840X_BENCHMARK_PUTS(line);
+            }
+        }
+        if (backend->leave != NULL)
+        {
+            backend->leave();
+        }
+    }
+    AD840X_BENCHMARK_PUTS("# done\n");
+}
+
+#endif /* AD840X_BENCHMARK */
@@ -0,0 +1,51 @@
+/*
+ * AD840X系列数字电位器驱动库 - SWO/ITM实时遥测
+ * 雪豹  编写
+ */
+#include "AD840X_ITM.h"
+
+#ifdef AD840X_USE_ITM
+
+#include "AD840X_Atomic.h"
+#include "AD840X_Time.h"
+
+static volatile uint32_t ad840x_itm_dropped;
+
+/**
+ * @brief  发送一个通道值数据包
+ * @param  hdev: AD840X设备句柄指针
+ * @param  channel: 通道地址
+ * @param  value: 锁存的通道值
+ * @retval None
+ */
+void AD840X_ITM_Send(const AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value)
+{
+    uint32_t word;
+
+    if (!AD840X_ITM_ENABLED(AD840X_ITM_PORT))
+    {
+        return;
+    }
+
+    /* SWO比SPI慢得多，FIFO满时丢弃而不是等待 */
+    if (!AD840X_ITM_FIFO_READY(AD840X_ITM_PORT))
+    {
+        AD840X_Atomic_FetchAdd(&ad840x_itm_dropped, 1U);
+        return;
+    }
+
+    word = ((AD840X_Time_Now() >> AD840X_ITM_TS_SHIFT) << 16) | ((uint32_t)(hdev->id & 0x3FU) << 10) |
+           ((uint32_t)(channel & 0x03U) << 8) | value;
+    AD840X_ITM_WRITE(AD840X_ITM_PORT, word);
+}
+
+/**
+ * @brief  读取FIFO满而丢弃的数据包数
+ * @retval 丢弃数
+ */
+uint32_t AD840X_ITM_Dropped(void)
+{
+    return ad840x_itm_dropped;
+}
+
+#endif /* AD840X_USE_ITM */
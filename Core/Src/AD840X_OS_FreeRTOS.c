@@ -0,0 +1,92 @@
+/*
+ * AD840X系列数字电位器驱动库 - RTOS集成层（FreeRTOS实现）
+ * 雪豹  编写
+ */
+#include "AD840X_OS.h"
+
+#ifdef AD840X_USE_RTOS
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+
+/**
+ * @brief  调度器是否已经启动
+ * @retval 1-已启动，0-未启动（此时不能阻塞）
+ */
+static uint8_t AD840X_OS_Running(void)
+{
+    return xTaskGetSchedulerState() == taskSCHEDULER_RUNNING;
+}
+
+/**
+ * @brief  为新注册的总线创建互斥量和完成信号量
+ * @param  bus: 总线指针
+ * @retval None
+ */
+void AD840X_OS_BusInit(AD840X_BusTypeDef *bus)
+{
+    bus->os_mutex = xSemaphoreCreateMutex();
+    bus->os_signal = xSemaphoreCreateBinary();
+
+    if (bus->os_mutex == NULL || bus->os_signal == NULL)
+    {
+        /* FreeRTOS堆不足，需要增大configTOTAL_HEAP_SIZE */
+        Error_Handler();
+    }
+}
+
+/**
+ * @brief  占有总线，其他任务在此阻塞
+ * @param  bus: 总线指针
+ * @retval None
+ */
+void AD840X_OS_BusLock(AD840X_BusTypeDef *bus)
+{
+    if (AD840X_OS_Running())
+    {
+        xSemaphoreTake((SemaphoreHandle_t)bus->os_mutex, portMAX_DELAY);
+    }
+}
+
+/**
+ * @brief  释放总线
+ * @param  bus: 总线指针
+ * @retval None
+ */
+void AD840X_OS_BusUnlock(AD840X_BusTypeDef *bus)
+{
+    if (AD840X_OS_Running())
+    {
+        xSemaphoreGive((SemaphoreHandle_t)bus->os_mutex);
+    }
+}
+
+/**
+ * @brief  阻塞等待总线的DMA完成通知
+ * @param  bus: 总线指针
+ * @note   调度器启动前直接返回，由调用者空转等待
+ * @retval None
+ */
+void AD840X_OS_BusWait(AD840X_BusTypeDef *bus)
+{
+    if (AD840X_OS_Running())
+    {
+        xSemaphoreTake((SemaphoreHandle_t)bus->os_signal, portMAX_DELAY);
+    }
+}
+
+/**
+ * @brief  在DMA完成中断中通知等待的任务
+ * @param  bus: 总线指针
+ * @retval None
+ */
+void AD840X_OS_BusSignalFromISR(AD840X_BusTypeDef *bus)
+{
+    BaseType_t woken = pdFALSE;
+
+    xSemaphoreGiveFromISR((SemaphoreHandle_t)bus->os_signal, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+#endif /* AD840X_USE_RTOS */
@@ -0,0 +1,231 @@
+/*
+ * AD840X系列数字电位器驱动库 - 多通道并行GPIO模拟SPI后端
+ * 雪豹  编写
+ */
+#include "AD840X_Parallel.h"
+#include "AD840X_Transport.h"
+#include "AD840X_Time.h"
+
+/* AD840X数据字长度：2位地址+8位数据（Page11 Table6） */
+#define AD840X_WORD_BITS 10
+
+/**
+ * @brief  把每个通道的10位数据字转换成逐位的BSRR值
+ * @param  planes: 输出，planes[b]为第b位对应的BSRR值
+ * @param  pin: 该通道的SDI引脚
+ * @param  word: 10位数据字
+ */
+static void AD840X_Parallel_AddPlanes(uint32_t *planes, uint16_t pin, uint16_t word)
+{
+    for (uint8_t bit = 0; bit < AD840X_WORD_BITS; bit++)
+    {
+        /* BSRR低16位置1，高16位清0 */
+        planes[bit] |= (word & (1U << bit)) ? pin : ((uint32_t)pin << 16);
+    }
+}
+
+/**
+ * @brief  在共用的SCK上移出10位，每位一次BSRR写入所有SDI
+ * @param  group: 并行组指针
+ * @param  planes: 逐位的BSRR值
+ * @note   MSB先发（Page10 Figure3），CS由调用者控制
+ */
+static void AD840X_Parallel_Shift(AD840X_ParallelTypeDef *group, const uint32_t *planes)
+{
+    GPIO_TypeDef *sdi = group->sdi_port;
+    GPIO_TypeDef *sck = group->sck_port;
+    uint32_t sck_high = group->sck_pin;
+    uint32_t sck_low = (uint32_t)group->sck_pin << 16;
+
+    for (int8_t bit = AD840X_WORD_BITS - 1; bit >= 0; bit--)
+    {
+        sdi->BSRR = planes[bit]; // SCK为低时更新数据，满足tDS
+        AD840X_PARALLEL_DELAY();
+        sck->BSRR = sck_high; // 上升沿移入
+        AD840X_PARALLEL_DELAY();
+        sck->BSRR = sck_low;
+    }
+}
+
+/**
+ * @brief  控制单个器件的CS引脚
+ * @param  hdev: AD840X设备句柄指针
+ * @param  active: 1-拉低选中，0-拉高释放
+ */
+static void AD840X_Parallel_Select(AD840X_HandleTypeDef *hdev, uint8_t active)
+{
+    hdev->cs_port->BSRR = active ? ((uint32_t)hdev->cs_pin << 16) : hdev->cs_pin;
+}
+
+/**
+ * @brief  单个器件的发送，只驱动该器件的SDI
+ * @param  hdev: AD840X设备句柄指针
+ * @param  data: 2字节帧数据
+ * @param  size: 字节数，必须为2
+ * @retval HAL状态
+ */
+static HAL_StatusTypeDef AD840X_Parallel_Transmit(AD840X_HandleTypeDef *hdev, const uint8_t *data, uint16_t size)
+{
+    AD840X_ParallelTypeDef *group = (AD840X_ParallelTypeDef *)hdev->transport_ctx;
+    uint32_t planes[AD840X_WORD_BITS] = {0};
+    uint8_t i = 0;
+
+    /* 组内所有器件共用一个transport_ctx（同一条总线），按设备句柄找到它的SDI */
+    while (i < group->num_lanes && group->lanes[i].hdev != hdev)
+    {
+        i++;
+    }
+    if (size != 2 || i >= group->num_lanes)
+    {
+        return HAL_ERROR;
+    }
+
+    AD840X_Parallel_AddPlanes(planes, group->lanes[i].sdi_pin, (uint16_t)(((uint16_t)data[0] << 8) | data[1]));
+    AD840X_Parallel_Shift(group, planes);
+    return HAL_OK;
+}
+
+/**
+ * @brief  通过BSRR寄存器控制SHDN/RS引脚
+ * @param  hdev: AD840X设备句柄指针
+ * @param  port: GPIO端口
+ * @param  pin: GPIO引脚
+ * @param  level: 1-高电平，0-低电平
+ */
+static void AD840X_Parallel_PinWrite(AD840X_HandleTypeDef *hdev, GPIO_TypeDef *port, uint16_t pin, uint8_t level)
+{
+    (void)hdev;
+    port->BSRR = level ? pin : ((uint32_t)pin << 16);
+}
+
+/**
+ * @brief  延时至少ns纳秒
+ * @param  hdev: AD840X设备句柄指针
+ * @param  ns: 纳秒
+ * @note   与其他后端相同，用DWT周期计数器按实际主频等待（见AD840X_Time.h），ts=2μs的唤醒只等2μs
+ */
+static void AD840X_Parallel_Delay(AD840X_HandleTypeDef *hdev, uint32_t ns)
+{
+    (void)hdev;
+    AD840X_Time_DelayNs(ns);
+}
+
+const AD840X_TransportTypeDef AD840X_Transport_Parallel = {
+    AD840X_Parallel_Select,
+    AD840X_Parallel_Transmit,
+    NULL, // 并行组只有SDI，没有回读
+    NULL,
+    AD840X_Parallel_PinWrite,
+    AD840X_Parallel_Delay,
+};
+
+/**
+ * @brief  初始化并行组
+ * @param  group: 并行组指针
+ * @param  sdi_port: 所有SDI引脚所在端口
+ * @param  sck_port: SCK端口
+ * @param  sck_pin: SCK引脚
+ * @param  cs_port: 所有CS引脚所在端口
+ * @retval None
+ */
+void AD840X_Parallel_Init(AD840X_ParallelTypeDef *group, GPIO_TypeDef *sdi_port,
+                          GPIO_TypeDef *sck_port, uint16_t sck_pin, GPIO_TypeDef *cs_port)
+{
+    group->sdi_port = sdi_port;
+    group->sck_port = sck_port;
+    group->sck_pin = sck_pin;
+    group->cs_port = cs_port;
+    group->num_lanes = 0;
+
+    /* SPI Mode 0，SCK空闲为低 */
+    sck_port->BSRR = (uint32_t)sck_pin << 16;
+}
+
+/**
+ * @brief  向并行组添加一个器件并初始化它的设备句柄
+ * @param  group: 并行组指针
+ * @param  hdev: AD840X设备句柄指针
+ * @param  sdi_pin: 该器件的SDI引脚（sdi_port上）
+ * @param  cs_pin: 该器件的CS引脚（cs_port上）
+ * @retval 通道编号（0~15），组已满时返回0xFF
+ */
+uint8_t AD840X_Parallel_AddLane(AD840X_ParallelTypeDef *group, AD840X_HandleTypeDef *hdev,
+                                uint16_t sdi_pin, uint16_t cs_pin)
+{
+    AD840X_ParallelLaneTypeDef *lane;
+
+    if (group->num_lanes >= AD840X_PARALLEL_MAX_LANES)
+    {
+        return 0xFF;
+    }
+
+    lane = &group->lanes[group->num_lanes];
+    lane->group = group;
+    lane->hdev = hdev;
+    lane->sdi_pin = sdi_pin;
+    lane->cs_pin = cs_pin;
+
+    AD840X_Init_Transport(hdev, &AD840X_Transport_Parallel, group, group->cs_port, cs_pin);
+
+    return group->num_lanes++;
+}
+
+/**
+ * @brief  在一帧时间内同时更新多个器件
+ * @param  group: 并行组指针
+ * @param  lanes: 参与本次更新的通道位掩码（bit n对应通道n）
+ * @param  channels: 每个通道要写的电位器通道地址（AD840X_CHANNEL_x），按通道编号索引
+ * @param  values: 每个通道要写的8位电阻值，按通道编号索引
+ * @note   电位器通道超出该器件型号的通道数时，该器件不参与本次更新
+ * @retval None
+ */
+void AD840X_Parallel_Write(AD840X_ParallelTypeDef *group, uint16_t lanes,
+                           const uint8_t *channels, const uint8_t *values)
+{
+    uint32_t planes[AD840X_WORD_BITS] = {0};
+    uint32_t trace[AD840X_PARALLEL_MAX_LANES];
+    uint32_t cs_mask = 0;
+    uint16_t sent = 0;
+
+    for (uint8_t i = 0; i < group->num_lanes; i++)
+    {
+        AD840X_ParallelLaneTypeDef *lane = &group->lanes[i];
+
+        if (!(lanes & (1U << i)) || channels[i] >= lane->hdev->num_channels)
+        {
+            continue;
+        }
+        /* 与AD840X_Write相同：重复值跳过，AD840X_Defer_Begin之后只记录 */
+        if (!AD840X_Transport_WriteBegin(lane->hdev, channels[i], values[i], &trace[i]))
+        {
+            continue;
+        }
+        AD840X_Parallel_AddPlanes(planes, lane->sdi_pin, (uint16_t)(((uint16_t)channels[i] << 8) | values[i]));
+        cs_mask |= lane->cs_pin;
+        sent |= (uint16_t)(1U << i);
+    }
+
+    if (cs_mask == 0)
+    {
+        return;
+    }
+
+    /* 组内器件共用一条总线，占有一次即可 */
+    AD840X_Transport_Lock(group->lanes[0].hdev);
+
+    /* 所有参与的器件同时选中、同时锁存（CS上升沿，Page10 Figure3） */
+    group->cs_port->BSRR = cs_mask << 16;
+    AD840X_Parallel_Shift(group, planes);
+    group->cs_port->BSRR = cs_mask;
+
+    /* 锁存之后再记录，遥测时间戳对应CS上升沿 */
+    for (uint8_t i = 0; i < group->num_lanes; i++)
+    {
+        if (sent & (1U << i))
+        {
+            AD840X_Transport_WriteEnd(group->lanes[i].hdev, channels[i], values[i], HAL_OK, trace[i]);
+        }
+    }
+
+    AD840X_Transport_Unlock(group->lanes[0].hdev);
+}
@@ -0,0 +1,149 @@
+/*
+ * AD840X系列数字电位器驱动库 - 多生产者命令队列
+ * 雪豹  编写
+ */
+#include "AD840X_Queue.h"
+#include "AD840X_Atomic.h"
+#ifdef AD840X_USE_TRACE
+#include "AD840X_Trace.h"
+#endif
+
+#define AD840X_QUEUE_MASK (AD840X_QUEUE_SIZE - 1U)
+
+/**
+ * @brief  初始化命令队列
+ * @param  queue: 队列指针
+ * @retval None
+ */
+void AD840X_Queue_Init(AD840X_QueueTypeDef *queue)
+{
+    for (uint32_t i = 0; i < AD840X_QUEUE_SIZE; i++)
+    {
+        queue->slots[i].seq = 0;
+    }
+    queue->head = 0;
+    queue->tail = 0;
+    queue->dropped = 0;
+}
+
+/**
+ * @brief  提交一条命令，可在中断中调用
+ * @param  queue: 队列指针
+ * @param  hdev: AD840X设备句柄指针
+ * @param  channel: 通道地址（AD840X_CHANNEL_x）
+ * @param  value: 8位电阻值（0-255）
+ * @retval 1-成功，0-队列已满（命令被丢弃，dropped加1）
+ */
+uint8_t AD840X_Queue_Push(AD840X_QueueTypeDef *queue, AD840X_HandleTypeDef *hdev, uint8_t channel,
+                          uint8_t value)
+{
+    AD840X_QueueSlotTypeDef *slot;
+    uint32_t tail;
+    uint32_t pos;
+
+    /* 抢占一个写入位置；被其他生产者（或打断本生产者的中断）抢先时重试 */
+    do
+    {
+        tail = queue->tail; // 先读tail再读head，保证pos - tail不会下溢
+        pos = queue->head;
+        if (pos - tail >= AD840X_QUEUE_SIZE)
+        {
+            AD840X_Atomic_FetchAdd(&queue->dropped, 1U);
+            return 0;
+        }
+    } while (!AD840X_Atomic_CAS(&queue->head, pos, pos + 1U));
+
+    /* 该槽位只属于本生产者，写完数据后再发布序号 */
+    slot = &queue->slots[pos & AD840X_QUEUE_MASK];
+    slot->cmd.hdev = hdev;
+    slot->cmd.channel = channel;
+    slot->cmd.value = value;
+    __DMB(); // 数据先于序号对消费者可见
+    slot->seq = pos + 1U;
+    return 1;
+}
+
+/**
+ * @brief  取出队列中所有已就绪的命令并发送
+ * @param  queue: 队列指针
+ * @note   只能在一个执行流（主循环或总线工作任务）中调用，不要在中断中调用
+ * @note   遇到已被抢占但还没写完的槽位时停止，剩余命令留到下一次
+ * @retval 本次发送的命令数
+ */
+uint16_t AD840X_Queue_Process(AD840X_QueueTypeDef *queue)
+{
+    uint16_t count = 0;
+    uint32_t pos = queue->tail;
+    AD840X_QueueSlotTypeDef *slot = &queue->slots[pos & AD840X_QUEUE_MASK];
+
+    while (slot->seq == pos + 1U)
+    {
+        AD840X_CommandTypeDef cmd;
+
+        __DMB(); // 读到序号后再读数据
+        cmd = slot->cmd;
+        __DMB(); // 数据读完后才把槽位还给生产者
+        queue->tail = ++pos;
+
+        AD840X_Write(cmd.hdev, cmd.channel, cmd.value);
+        count++;
+        slot = &queue->slots[pos & AD840X_QUEUE_MASK];
+    }
+    return count;
+}
+
+/**
+ * @brief  把通道的新值放入邮箱，覆盖尚未发送的旧值，可在中断中调用
+ * @param  hdev: AD840X设备句柄指针
+ * @param  channel: 通道地址（AD840X_CHANNEL_x）
+ * @param  value: 8位电阻值（0-255）
+ * @retval None
+ */
+void AD840X_Mailbox_Post(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value)
+{
+    if (channel >= hdev->num_channels)
+    {
+        return;
+    }
+
+#ifdef AD840X_USE_TRACE
+    if (hdev->mailbox_dirty & (1UL << channel))
+    {
+        /* 上一个值还没发送就被覆盖 */
+        AD840X_Trace_Event(hdev, channel, hdev->mailbox[channel], AD840X_TRACE_COALESCED);
+    }
+#endif
+    hdev->mailbox[channel] = value;
+    __DMB(); // 新值先于脏位对工作者可见
+    AD840X_Atomic_Or(&hdev->mailbox_dirty, 1UL << channel);
+}
+
+/**
+ * @brief  发送各设备邮箱中所有脏通道的最新值
+ * @param  devs: 设备句柄指针数组
+ * @param  count: 设备数量
+ * @note   只能在一个执行流（主循环或总线工作任务）中调用，不要在中断中调用
+ * @note   取走脏位后才读槽位，期间被覆盖的值会在下一轮再次发送，最新值不会丢失
+ * @retval 本次发送的帧数
+ */
+uint16_t AD840X_Mailbox_Process(AD840X_HandleTypeDef *const *devs, uint8_t count)
+{
+    uint16_t frames = 0;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        AD840X_HandleTypeDef *hdev = devs[i];
+        uint32_t dirty = AD840X_Atomic_Exchange(&hdev->mailbox_dirty, 0);
+
+        __DMB(); // 取走脏位后再读槽位
+        for (uint8_t channel = 0; dirty != 0U; channel++, dirty >>= 1)
+        {
+            if (dirty & 1U)
+            {
+                AD840X_Write(hdev, channel, *(volatile uint8_t *)&hdev->mailbox[channel]);
+                frames++;
+            }
+        }
+    }
+    return frames;
+}
@@ -0,0 +1,128 @@
+/*
+ * AD840X系列数字电位器驱动库 - STOP模式挂起/恢复
+ * 雪豹  编写
+ */
+#include "AD840X_Stop.h"
+
+/**
+ * @brief  打开SPI和DMA的外设时钟
+ * @param  ctx: 挂起现场指针
+ * @note   时钟关闭时寄存器读出为0，比较之前必须先打开
+ */
+static void AD840X_Stop_ClockEnable(const AD840X_StopTypeDef *ctx)
+{
+    /* STM32F1的SPI1挂在APB2上，SPI2/SPI3挂在APB1上，DMA挂在AHB上 */
+    if (ctx->spi == SPI1)
+    {
+        SET_BIT(RCC->APB2ENR, RCC_APB2ENR_SPI1EN);
+    }
+    else if (ctx->spi == SPI2)
+    {
+        SET_BIT(RCC->APB1ENR, RCC_APB1ENR_SPI2EN);
+    }
+#ifdef SPI3
+    else if (ctx->spi == SPI3)
+    {
+        SET_BIT(RCC->APB1ENR, RCC_APB1ENR_SPI3EN);
+    }
+#endif
+
+    if (ctx->dma != NULL)
+    {
+#ifdef DMA2
+        if ((uint32_t)ctx->dma >= (uint32_t)DMA2_Channel1)
+        {
+            SET_BIT(RCC->AHBENR, RCC_AHBENR_DMA2EN);
+        }
+        else
+#endif
+        {
+            SET_BIT(RCC->AHBENR, RCC_AHBENR_DMA1EN);
+        }
+    }
+
+    /* 读回一次，等时钟使能生效（与__HAL_RCC_xxx_CLK_ENABLE相同） */
+    (void)READ_REG(RCC->AHBENR);
+}
+
+/**
+ * @brief  初始化一条总线的挂起现场
+ * @param  ctx: 挂起现场指针
+ * @param  spi: SPI外设（SPI1/SPI2）
+ * @param  dma: TX方向的DMA通道，不使用DMA时传NULL
+ * @retval None
+ */
+void AD840X_Stop_Init(AD840X_StopTypeDef *ctx, SPI_TypeDef *spi, DMA_Channel_TypeDef *dma)
+{
+    ctx->spi = spi;
+    ctx->dma = dma;
+    ctx->cr1 = 0;
+    ctx->cr2 = 0;
+    ctx->ccr = 0;
+    ctx->cpar = 0;
+    ctx->reloads = 0;
+}
+
+/**
+ * @brief  进入STOP模式前调用：等待总线空闲，保存SPI/DMA配置，开始推迟写入
+ * @param  ctx: 挂起现场数组，每条SPI总线一个
+ * @param  count: 数组长度
+ * @retval None
+ */
+void AD840X_Suspend(AD840X_StopTypeDef *ctx, uint8_t count)
+{
+    /* 先让队列发完，保存的是空闲时的配置 */
+    AD840X_Defer_Begin();
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        ctx[i].cr1 = (uint16_t)ctx[i].spi->CR1;
+        ctx[i].cr2 = (uint16_t)ctx[i].spi->CR2;
+        if (ctx[i].dma != NULL)
+        {
+            ctx[i].ccr = ctx[i].dma->CCR & ~DMA_CCR_EN;
+            ctx[i].cpar = ctx[i].dma->CPAR;
+        }
+    }
+}
+
+/**
+ * @brief  唤醒后调用：写回被改动的SPI/DMA配置，补发挂起期间写入的通道
+ * @param  ctx: 挂起现场数组，与AD840X_Suspend相同
+ * @param  count: 数组长度
+ * @param  devs: 设备句柄指针数组
+ * @param  dev_count: 设备数量
+ * @retval 补发的帧数
+ */
+uint16_t AD840X_Resume(AD840X_StopTypeDef *ctx, uint8_t count,
+                       AD840X_HandleTypeDef *const *devs, uint8_t dev_count)
+{
+    for (uint8_t i = 0; i < count; i++)
+    {
+        SPI_TypeDef *spi = ctx[i].spi;
+        DMA_Channel_TypeDef *dma = ctx[i].dma;
+        uint8_t reload = 0;
+
+        AD840X_Stop_ClockEnable(&ctx[i]);
+
+        /* 寄存器一般保持不变，只比较不写入；被改动时直接写回，不走HAL_SPI_Init */
+        if ((uint16_t)spi->CR1 != ctx[i].cr1 || (uint16_t)spi->CR2 != ctx[i].cr2)
+        {
+            /* 关闭SPE后写入，最后再按保存的值打开 */
+            spi->CR1 = ctx[i].cr1 & ~SPI_CR1_SPE;
+            spi->CR2 = ctx[i].cr2;
+            spi->CR1 = ctx[i].cr1;
+            reload = 1;
+        }
+        if (dma != NULL && ((dma->CCR & ~DMA_CCR_EN) != ctx[i].ccr || dma->CPAR != ctx[i].cpar))
+        {
+            /* EN为0时才能修改；存储器地址和长度由传输后端在每帧发送前写入 */
+            dma->CCR = ctx[i].ccr;
+            dma->CPAR = ctx[i].cpar;
+            reload = 1;
+        }
+        ctx[i].reloads += reload;
+    }
+
+    return AD840X_Defer_End(devs, dev_count);
+}
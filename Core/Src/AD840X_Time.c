@@ -0,0 +1,72 @@
+/*
+ * AD840X系列数字电位器驱动库 - 微秒级计时
+ * 雪豹  编写
+ */
+#include "AD840X_Time.h"
+
+/**
+ * @brief  初始化计时（打开DWT周期计数器）
+ * @note   AD840X_Init/AD840X_Init_Transport中已调用；不清零CYCCNT，不影响其他使用者
+ * @retval None
+ */
+void AD840X_Time_Init(void)
+{
+#ifdef AD840X_TIME_USE_DWT
+    /* 不接调试器运行时DWT默认关闭，要先打开跟踪使能 */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+/**
+ * @brief  纳秒换算为计数周期数，向上取整
+ * @param  ns: 纳秒
+ * @retval 计数周期数
+ */
+uint32_t AD840X_Time_Cycles(uint32_t ns)
+{
+    /* 按完整的Hz换算，主频不是整MHz（例如64.5MHz或校准过的HSI）时也不会少等 */
+    return (uint32_t)(((uint64_t)ns * AD840X_TIME_HZ + 999999999U) / 1000000000U);
+}
+
+/**
+ * @brief  阻塞延时至少ns纳秒
+ * @param  ns: 纳秒（不超过AD840X_TIME_MAX_NS）
+ * @note   可在中断中调用
+ * @retval None
+ */
+void AD840X_Time_DelayNs(uint32_t ns)
+{
+    uint32_t start = AD840X_Time_Now();
+    uint32_t cycles = AD840X_Time_Cycles(ns) + 1U; // 开始时刻可能落在一个计数周期中间
+
+    while (AD840X_Time_Now() - start < cycles)
+    {
+    }
+}
+
+/**
+ * @brief  阻塞延时至少us微秒
+ * @param  us: 微秒
+ * @retval None
+ */
+void AD840X_Time_DelayUs(uint32_t us)
+{
+    /* 超过单次上限时分段等待 */
+    while (us > AD840X_TIME_MAX_NS / 1000U)
+    {
+        AD840X_Time_DelayNs(AD840X_TIME_MAX_NS);
+        us -= AD840X_TIME_MAX_NS / 1000U;
+    }
+    AD840X_Time_DelayNs(us * 1000U);
+}
+
+/**
+ * @brief  计数周期数换算为微秒
+ * @param  cycles: 计数周期数（两次AD840X_Time_Now之差）
+ * @retval 微秒
+ */
+uint32_t AD840X_Time_ToUs(uint32_t cycles)
+{
+    return (uint32_t)((uint64_t)cycles * 1000000U / AD840X_TIME_HZ);
+}
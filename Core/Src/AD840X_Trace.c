@@ -0,0 +1,155 @@
+/*
+ * AD840X系列数字电位器驱动库 - 命令跟踪
+ * 雪豹  编写
+ */
+#include "AD840X_Trace.h"
+
+#ifdef AD840X_USE_TRACE
+
+#include <stdio.h>
+#include "AD840X_Atomic.h"
+#include "AD840X_Time.h"
+
+#define AD840X_TRACE_MASK (AD840X_TRACE_SIZE - 1U)
+
+static AD840X_TraceEntryTypeDef ad840x_trace[AD840X_TRACE_SIZE];
+static volatile uint32_t ad840x_trace_head; // 已分配的最大序号
+static volatile uint32_t ad840x_trace_base; // AD840X_Trace_Clear时的head，之前的记录不再读出
+
+/**
+ * @brief  记录一条命令
+ * @param  hdev: AD840X设备句柄指针
+ * @param  channel: 通道地址
+ * @param  value: 写入值
+ * @param  path: 路径（AD840X_TracePathTypeDef）
+ * @retval 记录序号
+ */
+uint32_t AD840X_Trace_Record(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value, uint8_t path)
+{
+    uint32_t now = AD840X_Time_Now();
+    uint32_t seq = AD840X_Atomic_FetchAdd(&ad840x_trace_head, 1U) + 1U;
+    AD840X_TraceEntryTypeDef *entry = &ad840x_trace[seq & AD840X_TRACE_MASK];
+
+    /* 先作废槽位再写内容，读者据此丢弃写了一半的记录 */
+    entry->seq = 0;
+    __DMB();
+    entry->t_submit = now;
+    entry->t_done = now;
+    entry->hdev = hdev;
+    entry->channel = channel;
+    entry->value = value;
+    entry->path = path;
+    entry->status = HAL_BUSY;
+    __DMB();
+    entry->seq = seq;
+    return seq;
+}
+
+/**
+ * @brief  记录一条不上总线的命令
+ * @param  hdev: AD840X设备句柄指针
+ * @param  channel: 通道地址
+ * @param  value: 写入值
+ * @param  path: 路径（AD840X_TracePathTypeDef）
+ * @retval None
+ */
+void AD840X_Trace_Event(AD840X_HandleTypeDef *hdev, uint8_t channel, uint8_t value, uint8_t path)
+{
+    uint32_t seq = AD840X_Trace_Record(hdev, channel, value, path);
+
+    ad840x_trace[seq & AD840X_TRACE_MASK].status = HAL_OK;
+}
+
+/**
+ * @brief  填写命令的完成时刻和状态
+ * @param  seq: AD840X_Trace_Record返回的序号
+ * @param  status: 完成状态
+ * @retval None
+ */
+void AD840X_Trace_Done(uint32_t seq, HAL_StatusTypeDef status)
+{
+    AD840X_TraceEntryTypeDef *entry = &ad840x_trace[seq & AD840X_TRACE_MASK];
+
+    if (entry->seq == seq)
+    {
+        entry->t_done = AD840X_Time_Now();
+        entry->status = (uint8_t)status;
+    }
+}
+
+/**
+ * @brief  复制最近的跟踪记录
+ * @param  out: 输出数组
+ * @param  max: 最多复制的条数
+ * @retval 实际复制的条数
+ */
+uint32_t AD840X_Trace_Read(AD840X_TraceEntryTypeDef *out, uint32_t max)
+{
+    uint32_t head = ad840x_trace_head;
+    uint32_t first = ad840x_trace_base;
+    uint32_t count = 0;
+
+    /* 只看缓冲区里还可能存在的、最近max条记录 */
+    if (head - first > AD840X_TRACE_SIZE)
+    {
+        first = head - AD840X_TRACE_SIZE;
+    }
+    if (head - first > max)
+    {
+        first = head - max;
+    }
+
+    for (uint32_t seq = first + 1U; seq != head + 1U; seq++)
+    {
+        const AD840X_TraceEntryTypeDef *entry = &ad840x_trace[seq & AD840X_TRACE_MASK];
+
+        if (entry->seq != seq)
+        {
+            continue; // 正在写入
+        }
+        __DMB();
+        out[count] = *entry;
+        __DMB();
+        if (entry->seq == seq)
+        {
+            count++; // 复制期间没有被覆盖
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief  逐行输出缓冲区中的全部记录
+ * @param  output: 输出函数
+ * @retval None
+ */
+void AD840X_Trace_Dump(AD840X_TraceOutputTypeDef output)
+{
+    static const char *const paths[] = {"blocking", "verify", "dma", "urgent", "skipped", "deferred", "coalesced"};
+    static AD840X_TraceEntryTypeDef entries[AD840X_TRACE_SIZE]; // 不占用调用者的栈
+    char line[80];
+    uint32_t count = AD840X_Trace_Read(entries, AD840X_TRACE_SIZE);
+
+    output("seq,t_submit,latency,cs_pin,channel,value,path,status\n");
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const AD840X_TraceEntryTypeDef *e = &entries[i];
+
+        snprintf(line, sizeof(line), "%lu,%lu,%lu,0x%04x,%u,%u,%s,%u\n", (unsigned long)e->seq,
+                 (unsigned long)e->t_submit, (unsigned long)(e->t_done - e->t_submit), e->hdev->cs_pin,
+                 e->channel, e->value, e->path < sizeof(paths) / sizeof(paths[0]) ? paths[e->path] : "?",
+                 e->status);
+        output(line);
+    }
+}
+
+/**
+ * @brief  清空跟踪缓冲区
+ * @retval None
+ */
+void AD840X_Trace_Clear(void)
+{
+    ad840x_trace_base = ad840x_trace_head;
+}
+
+#endif /* AD840X_USE_TRACE */
@@ -0,0 +1,263 @@
+/*
+ * AD840X系列数字电位器驱动库 - 传输后端
+ * 雪豹  编写
+ */
+#include "AD840X_Transport.h"
+#include "AD840X_Time.h"
+
+/* ====================== 公共操作 ====================== */
+
+/**
+ * @brief  通过HAL库控制CS引脚
+ * @param  hdev: AD840X设备句柄指针
+ * @param  active: 1-拉低选中，0-拉高释放
+ */
+static void AD840X_HAL_Select(AD840X_HandleTypeDef *hdev, uint8_t active)
+{
+    HAL_GPIO_WritePin(hdev->cs_port, hdev->cs_pin, active ? GPIO_PIN_RESET : GPIO_PIN_SET);
+}
+
+/**
+ * @brief  通过HAL库控制SHDN/RS引脚
+ * @param  hdev: AD840X设备句柄指针
+ * @param  port: GPIO端口
+ * @param  pin: GPIO引脚
+ * @param  level: 1-高电平，0-低电平
+ */
+static void AD840X_HAL_PinWrite(AD840X_HandleTypeDef *hdev, GPIO_TypeDef *port, uint16_t pin, uint8_t level)
+{
+    (void)hdev;
+    HAL_GPIO_WritePin(port, pin, level ? GPIO_PIN_SET : GPIO_PIN_RESET);
+}
+
+/**
+ * @brief  延时至少ns纳秒
+ * @param  hdev: AD840X设备句柄指针
+ * @param  ns: 纳秒
+ * @note   各后端共用，不经过HAL：用DWT周期计数器按实际主频等待（见AD840X_Time.h），ts=2μs的唤醒只等2μs
+ */
+static void AD840X_Transport_Delay(AD840X_HandleTypeDef *hdev, uint32_t ns)
+{
+    (void)hdev;
+    AD840X_Time_DelayNs(ns);
+}
+
+/**
+ * @brief  通过BSRR寄存器控制CS引脚
+ * @param  hdev: AD840X设备句柄指针
+ * @param  active: 1-拉低选中，0-拉高释放
+ */
+static void AD840X_Reg_Select(AD840X_HandleTypeDef *hdev, uint8_t active)
+{
+    hdev->cs_port->BSRR = active ? ((uint32_t)hdev->cs_pin << 16) : hdev->cs_pin;
+}
+
+/**
+ * @brief  通过BSRR寄存器控制SHDN/RS引脚
+ * @param  hdev: AD840X设备句柄指针
+ * @param  port: GPIO端口
+ * @param  pin: GPIO引脚
+ * @param  level: 1-高电平，0-低电平
+ */
+static void AD840X_Reg_PinWrite(AD840X_HandleTypeDef *hdev, GPIO_TypeDef *port, uint16_t pin, uint8_t level)
+{
+    (void)hdev;
+    port->BSRR = level ? pin : ((uint32_t)pin << 16);
+}
+
+/* ====================== HAL库阻塞/DMA ====================== */
+
+#ifdef HAL_SPI_MODULE_ENABLED
+
+/**
+ * @brief  通过HAL库阻塞发送
+ * @param  hdev: AD840X设备句柄指针
+ * @param  data: 待发送数据
+ * @param  size: 字节数
+ * @retval HAL状态
+ */
+static HAL_StatusTypeDef AD840X_HAL_Transmit(AD840X_HandleTypeDef *hdev, const uint8_t *data, uint16_t size)
+{
+    return HAL_SPI_Transmit((SPI_HandleTypeDef *)hdev->transport_ctx, (uint8_t *)data, size, HAL_MAX_DELAY);
+}
+
+/**
+ * @brief  通过HAL库阻塞全双工收发
+ * @param  hdev: AD840X设备句柄指针
+ * @param  tx: 待发送数据
+ * @param  rx: 接收缓冲区
+ * @param  size: 字节数
+ * @retval HAL状态
+ */
+static HAL_StatusTypeDef AD840X_HAL_TransmitReceive(AD840X_HandleTypeDef *hdev, const uint8_t *tx,
+                                                    uint8_t *rx, uint16_t size)
+{
+    return HAL_SPI_TransmitReceive((SPI_HandleTypeDef *)hdev->transport_ctx, (uint8_t *)tx, rx, size,
+                                   HAL_MAX_DELAY);
+}
+
+/**
+ * @brief  通过HAL库启动DMA发送
+ * @param  hdev: AD840X设备句柄指针
+ * @param  data: 待发送数据，传输完成前必须保持有效
+ * @param  size: 字节数
+ * @retval HAL状态
+ * @note   完成后HAL_SPI_TxCpltCallback -> AD840X_SPI_TxCpltCallback -> AD840X_Transport_TxComplete
+ */
+static HAL_StatusTypeDef AD840X_HAL_Transmit_DMA(AD840X_HandleTypeDef *hdev, const uint8_t *data, uint16_t size)
+{
+    return HAL_SPI_Transmit_DMA((SPI_HandleTypeDef *)hdev->transport_ctx, (uint8_t *)data, size);
+}
+
+const AD840X_TransportTypeDef AD840X_Transport_HAL = {
+    AD840X_HAL_Select,
+    AD840X_HAL_Transmit,
+    AD840X_HAL_TransmitReceive,
+    NULL,
+    AD840X_HAL_PinWrite,
+    AD840X_Transport_Delay,
+};
+
+const AD840X_TransportTypeDef AD840X_Transport_HAL_DMA = {
+    AD840X_HAL_Select,
+    AD840X_HAL_Transmit,
+    AD840X_HAL_TransmitReceive,
+    AD840X_HAL_Transmit_DMA,
+    AD840X_HAL_PinWrite,
+    AD840X_Transport_Delay,
+};
+#endif /* HAL_SPI_MODULE_ENABLED */
+
+/* ====================== 寄存器直接访问 ====================== */
+
+/**
+ * @brief  直接写DR寄存器阻塞发送
+ * @param  hdev: AD840X设备句柄指针
+ * @param  data: 待发送数据
+ * @param  size: 字节数
+ * @retval HAL_OK
+ */
+static HAL_StatusTypeDef AD840X_Reg_Transmit(AD840X_HandleTypeDef *hdev, const uint8_t *data, uint16_t size)
+{
+    AD840X_Reg_Send((SPI_TypeDef *)hdev->transport_ctx, data, size);
+    return HAL_OK;
+}
+
+/**
+ * @brief  直接读写DR寄存器阻塞全双工收发
+ * @param  hdev: AD840X设备句柄指针
+ * @param  tx: 待发送数据
+ * @param  rx: 接收缓冲区
+ * @param  size: 字节数
+ * @retval HAL_OK
+ */
+static HAL_StatusTypeDef AD840X_Reg_TransmitReceive(AD840X_HandleTypeDef *hdev, const uint8_t *tx,
+                                                    uint8_t *rx, uint16_t size)
+{
+    SPI_TypeDef *spi = (SPI_TypeDef *)hdev->transport_ctx;
+
+    AD840X_Reg_Enable(spi);
+    (void)spi->DR; // 丢弃之前残留的数据
+    for (uint16_t i = 0; i < size; i++)
+    {
+        while (!(spi->SR & SPI_SR_TXE))
+        {
+        }
+        *(volatile uint8_t *)&spi->DR = tx[i];
+        while (!(spi->SR & SPI_SR_RXNE))
+        {
+        }
+        rx[i] = *(volatile uint8_t *)&spi->DR;
+    }
+    while (spi->SR & SPI_SR_BSY)
+    {
+    }
+    return HAL_OK;
+}
+
+const AD840X_TransportTypeDef AD840X_Transport_Reg = {
+    AD840X_Reg_Select,
+    AD840X_Reg_Transmit,
+    AD840X_Reg_TransmitReceive,
+    NULL,
+    AD840X_Reg_PinWrite,
+    AD840X_Transport_Delay,
+};
+
+/* ====================== GPIO模拟SPI ====================== */
+
+/**
+ * @brief  GPIO模拟SPI Mode 0收发一个字节，MSB先发
+ * @param  bb: 引脚配置
+ * @param  out: 发送的字节
+ * @retval 从SDO收到的字节（未配置SDO时为0）
+ */
+static uint8_t AD840X_BitBang_Byte(const AD840X_BitBangTypeDef *bb, uint8_t out)
+{
+    uint8_t in = 0;
+
+    for (uint8_t bit = 0; bit < 8; bit++)
+    {
+        /* SCK为低时更新数据，满足tDS */
+        bb->sdi_port->BSRR = (out & 0x80U) ? bb->sdi_pin : ((uint32_t)bb->sdi_pin << 16);
+        out <<= 1;
+        AD840X_BITBANG_DELAY();
+
+        bb->sck_port->BSRR = bb->sck_pin; // 上升沿移入
+        in <<= 1;
+        if (bb->sdo_port != NULL && (bb->sdo_port->IDR & bb->sdo_pin))
+        {
+            in |= 1U;
+        }
+        AD840X_BITBANG_DELAY();
+        bb->sck_port->BSRR = (uint32_t)bb->sck_pin << 16;
+    }
+    return in;
+}
+
+/**
+ * @brief  GPIO模拟SPI阻塞发送
+ * @param  hdev: AD840X设备句柄指针
+ * @param  data: 待发送数据
+ * @param  size: 字节数
+ * @retval HAL_OK
+ */
+static HAL_StatusTypeDef AD840X_BitBang_Transmit(AD840X_HandleTypeDef *hdev, const uint8_t *data, uint16_t size)
+{
+    const AD840X_BitBangTypeDef *bb = (const AD840X_BitBangTypeDef *)hdev->transport_ctx;
+
+    for (uint16_t i = 0; i < size; i++)
+    {
+        AD840X_BitBang_Byte(bb, data[i]);
+    }
+    return HAL_OK;
+}
+
+/**
+ * @brief  GPIO模拟SPI阻塞全双工收发
+ * @param  hdev: AD840X设备句柄指针
+ * @param  tx: 待发送数据
+ * @param  rx: 接收缓冲区
+ * @param  size: 字节数
+ * @retval HAL_OK，未配置SDO引脚时返回HAL_ERROR
+ */
+static HAL_StatusTypeDef AD840X_BitBang_TransmitReceive(AD840X_HandleTypeDef *hdev, const uint8_t *tx,
+                                                        uint8_t *rx, uint16_t size)
+{
+    const AD840X_BitBangTypeDef *bb = (const AD840X_BitBangTypeDef *)hdev->transport_ctx;
+
+    for (uint16_t i = 0; i < size; i++)
+    {
+        rx[i] = AD840X_BitBang_Byte(bb, tx[i]);
+    }
+    return (bb->sdo_port != NULL) ? HAL_OK : HAL_ERROR;
+}
+
+const AD840X_TransportTypeDef AD840X_Transport_BitBang = {
+    AD840X_Reg_Select,
+    AD840X_BitBang_Transmit,
+    AD840X_BitBang_TransmitReceive,
+    NULL,
+    AD840X_Reg_PinWrite,
+    AD840X_Transport_Delay,
+};
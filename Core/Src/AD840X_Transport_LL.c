@@ -0,0 +1,264 @@
+/*
+ * AD840X系列数字电位器驱动库 - LL库传输后端
+ * 雪豹  编写
+ */
+#include "AD840X_Transport_LL.h"
+
+/**
+ * @brief  通过LL库控制CS引脚
+ * @param  hdev: AD840X设备句柄指针
+ * @param  active: 1-拉低选中，0-拉高释放
+ */
+static void AD840X_LL_Select(AD840X_HandleTypeDef *hdev, uint8_t active)
+{
+    if (active)
+    {
+        LL_GPIO_ResetOutputPin(hdev->cs_port, AD840X_LL_PIN(hdev->cs_pin));
+    }
+    else
+    {
+        LL_GPIO_SetOutputPin(hdev->cs_port, AD840X_LL_PIN(hdev->cs_pin));
+    }
+}
+
+/**
+ * @brief  通过LL库控制SHDN/RS引脚
+ * @param  hdev: AD840X设备句柄指针
+ * @param  port: GPIO端口
+ * @param  pin: GPIO引脚
+ * @param  level: 1-高电平，0-低电平
+ */
+static void AD840X_LL_PinWrite(AD840X_HandleTypeDef *hdev, GPIO_TypeDef *port, uint16_t pin, uint8_t level)
+{
+    (void)hdev;
+    if (level)
+    {
+        LL_GPIO_SetOutputPin(port, AD840X_LL_PIN(pin));
+    }
+    else
+    {
+        LL_GPIO_ResetOutputPin(port, AD840X_LL_PIN(pin));
+    }
+}
+
+/**
+ * @brief  延时至少ns纳秒
+ * @param  hdev: AD840X设备句柄指针
+ * @param  ns: 纳秒
+ * @note   与AD840X_Transport_Reg相同
+ */
+static void AD840X_LL_Delay(AD840X_HandleTypeDef *hdev, uint32_t ns)
+{
+    AD840X_Transport_Reg.Delay(hdev, ns);
+}
+
+/**
+ * @brief  等最后一位移出，丢弃全双工模式下收到的数据并清除OVR标志
+ * @param  spi: SPI外设
+ */
+static void AD840X_LL_Drain(SPI_TypeDef *spi)
+{
+    while (!LL_SPI_IsActiveFlag_TXE(spi))
+    {
+    }
+    while (LL_SPI_IsActiveFlag_BSY(spi))
+    {
+    }
+    (void)LL_SPI_ReceiveData8(spi);
+    LL_SPI_ClearFlag_OVR(spi);
+}
+
+/**
+ * @brief  通过LL库阻塞发送
+ * @param  hdev: AD840X设备句柄指针
+ * @param  data: 待发送数据
+ * @param  size: 字节数
+ * @retval HAL_OK
+ */
+static HAL_StatusTypeDef AD840X_LL_Transmit(AD840X_HandleTypeDef *hdev, const uint8_t *data, uint16_t size)
+{
+    SPI_TypeDef *spi = ((AD840X_LLTypeDef *)hdev->transport_ctx)->spi;
+
+    for (uint16_t i = 0; i < size; i++)
+    {
+        while (!LL_SPI_IsActiveFlag_TXE(spi))
+        {
+        }
+        LL_SPI_TransmitData8(spi, data[i]);
+    }
+
+    /* 等最后一位移出后才能拉高CS */
+    AD840X_LL_Drain(spi);
+    return HAL_OK;
+}
+
+/**
+ * @brief  通过LL库阻塞全双工收发
+ * @param  hdev: AD840X设备句柄指针
+ * @param  tx: 待发送数据
+ * @param  rx: 接收缓冲区
+ * @param  size: 字节数
+ * @retval HAL_OK
+ */
+static HAL_StatusTypeDef AD840X_LL_TransmitReceive(AD840X_HandleTypeDef *hdev, const uint8_t *tx,
+                                                   uint8_t *rx, uint16_t size)
+{
+    SPI_TypeDef *spi = ((AD840X_LLTypeDef *)hdev->transport_ctx)->spi;
+
+    (void)LL_SPI_ReceiveData8(spi); // 丢弃之前残留的数据
+    for (uint16_t i = 0; i < size; i++)
+    {
+        while (!LL_SPI_IsActiveFlag_TXE(spi))
+        {
+        }
+        LL_SPI_TransmitData8(spi, tx[i]);
+        while (!LL_SPI_IsActiveFlag_RXNE(spi))
+        {
+        }
+        rx[i] = LL_SPI_ReceiveData8(spi);
+    }
+    while (LL_SPI_IsActiveFlag_BSY(spi))
+    {
+    }
+    return HAL_OK;
+}
+
+/**
+ * @brief  通过LL库启动DMA发送
+ * @param  hdev: AD840X设备句柄指针
+ * @param  data: 待发送数据，传输完成前必须保持有效
+ * @param  size: 字节数
+ * @retval HAL状态，总线未配置DMA时返回HAL_ERROR
+ * @note   完成后DMA1_ChannelX_IRQHandler -> AD840X_LL_DMA_IRQHandler -> AD840X_Transport_TxComplete
+ */
+static HAL_StatusTypeDef AD840X_LL_Transmit_DMA(AD840X_HandleTypeDef *hdev, const uint8_t *data, uint16_t size)
+{
+    AD840X_LLTypeDef *ll = (AD840X_LLTypeDef *)hdev->transport_ctx;
+
+    if (ll->dma == NULL)
+    {
+        return HAL_ERROR;
+    }
+
+    /* 普通模式下传输完成后EN仍为1，必须先关闭通道才能修改地址和长度 */
+    LL_DMA_DisableChannel(ll->dma, ll->dma_channel);
+    LL_DMA_SetMemoryAddress(ll->dma, ll->dma_channel, (uint32_t)data);
+    LL_DMA_SetDataLength(ll->dma, ll->dma_channel, size);
+    LL_DMA_EnableChannel(ll->dma, ll->dma_channel);
+    return HAL_OK;
+}
+
+const AD840X_TransportTypeDef AD840X_Transport_LL = {
+    AD840X_LL_Select,
+    AD840X_LL_Transmit,
+    AD840X_LL_TransmitReceive,
+    NULL,
+    AD840X_LL_PinWrite,
+    AD840X_LL_Delay,
+};
+
+const AD840X_TransportTypeDef AD840X_Transport_LL_DMA = {
+    AD840X_LL_Select,
+    AD840X_LL_Transmit,
+    AD840X_LL_TransmitReceive,
+    AD840X_LL_Transmit_DMA,
+    AD840X_LL_PinWrite,
+    AD840X_LL_Delay,
+};
+
+/**
+ * @brief  初始化LL后端的SPI总线
+ * @param  ll: 总线指针，同一SPI上的设备共用
+ * @param  spi: SPI外设（SPI1/SPI2）
+ * @param  dma: TX方向的DMA控制器，不使用DMA时传NULL
+ * @param  dma_channel: TX方向的DMA通道（LL_DMA_CHANNEL_x），不使用DMA时传0
+ * @note   在MX_SPIx_Init、MX_DMA_Init之后调用。会配置DMA通道的传输方向、数据宽度并打开完成中断
+ * @retval None
+ */
+void AD840X_LL_Init(AD840X_LLTypeDef *ll, SPI_TypeDef *spi, DMA_TypeDef *dma, uint32_t dma_channel)
+{
+    ll->spi = spi;
+    ll->dma = dma;
+    ll->dma_channel = dma_channel;
+
+    if (dma != NULL)
+    {
+        /* 存储器到外设、普通模式、字节宽度，每帧2字节 */
+        LL_DMA_DisableChannel(dma, dma_channel);
+        LL_DMA_ConfigTransfer(dma, dma_channel,
+                              LL_DMA_DIRECTION_MEMORY_TO_PERIPH | LL_DMA_MODE_NORMAL |
+                                  LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT |
+                                  LL_DMA_PDATAALIGN_BYTE | LL_DMA_MDATAALIGN_BYTE | LL_DMA_PRIORITY_HIGH);
+        LL_DMA_SetPeriphAddress(dma, dma_channel, LL_SPI_DMA_GetRegAddr(spi));
+        LL_DMA_EnableIT_TC(dma, dma_channel);
+        LL_DMA_EnableIT_TE(dma, dma_channel);
+        LL_SPI_EnableDMAReq_TX(spi);
+    }
+
+    /* CubeMX生成的LL初始化代码不使能SPI */
+    if (!LL_SPI_IsEnabled(spi))
+    {
+        LL_SPI_Enable(spi);
+    }
+}
+
+/**
+ * @brief  根据当前PCLK选择不超过上限的最快SPI分频系数
+ * @param  ll: 总线指针
+ * @param  max_hz: 允许的最高SCK频率，一般传AD840X_SPI_MAX_CLOCK_HZ
+ * @retval 实际的SCK频率（Hz）
+ * @note   与AD840X_SPI_PlanClock相同，用于没有HAL SPI句柄的场合；调用时总线上不能有正在发送的帧
+ */
+uint32_t AD840X_LL_PlanClock(AD840X_LLTypeDef *ll, uint32_t max_hz)
+{
+    /* STM32F1的SPI1挂在APB2上，SPI2/SPI3挂在APB1上 */
+    uint32_t pclk = (ll->spi == SPI1) ? HAL_RCC_GetPCLK2Freq() : HAL_RCC_GetPCLK1Freq();
+    uint32_t br = 0;
+
+    /* 从2分频开始，找到第一个不超过上限的分频系数，最大256分频 */
+    while (br < 7U && (pclk >> (br + 1U)) > max_hz)
+    {
+        br++;
+    }
+
+    /* BR只能在SPI关闭时修改 */
+    while (LL_SPI_IsActiveFlag_BSY(ll->spi))
+    {
+    }
+    LL_SPI_Disable(ll->spi);
+    LL_SPI_SetBaudRatePrescaler(ll->spi, br << SPI_CR1_BR_Pos);
+    LL_SPI_Enable(ll->spi);
+
+    return pclk >> (br + 1U);
+}
+
+/**
+ * @brief  DMA发送完成中断处理
+ * @param  ll: 总线指针
+ * @note   在DMA1_ChannelX_IRQHandler中调用，负责拉高CS并启动队列中的下一帧
+ * @note   DMA传输错误时同样结束当前帧，丢弃出错的帧并继续发送队列
+ * @retval None
+ */
+void AD840X_LL_DMA_IRQHandler(AD840X_LLTypeDef *ll)
+{
+    /* 每个通道在ISR/IFCR中占4位，通道1从第0位开始 */
+    uint32_t shift = (ll->dma_channel - 1U) * 4U;
+    uint32_t flags = ll->dma->ISR & ((DMA_ISR_TCIF1 | DMA_ISR_TEIF1) << shift);
+
+    if (!flags)
+    {
+        return;
+    }
+    WRITE_REG(ll->dma->IFCR, DMA_IFCR_CGIF1 << shift);
+
+    /* DMA完成时最后一个字节还在移位寄存器中 */
+    AD840X_LL_Drain(ll->spi);
+    if (flags & (DMA_ISR_TEIF1 << shift))
+    {
+        AD840X_Transport_TxError(ll);
+    }
+    else
+    {
+        AD840X_Transport_TxComplete(ll);
+    }
+}
@@ -22,7 +22,8 @@
  * 说明在AD840X.h文件中，也可以看readme.md
  * 如果您需要在其他项目中使用这个AD840X驱动，只需：
  * 1. 在STM32CubeMX中配置SPI外设和GPIO引脚
- * 2. 拷贝AD840X.c和AD840X.h两个文件
+ * 2. 拷贝AD840X.c、AD840X_Transport.c、AD840X_Time.c和对应的AD840X.h、AD840X_Transport.h、AD840X_Time.h，
+ *    以及AD840X_Atomic.h（其余AD840X_*文件按需拷贝）
  * 3. 在您的代码中包含AD840X.h头文件（见第38行）
  * 4. 创建AD840X_HandleTypeDef结构体变量并调用AD840X_Init初始化（见第59行）
  * 5. 然后就可以自由使用AD840X_Write函数了
@@ -36,6 +37,7 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "AD840X.h" // 引入AD840X驱动库
+#include "AD840X_Benchmark.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -102,8 +104,17 @@ int main(void)
   MX_GPIO_Init();
   MX_SPI1_Init();
   /* USER CODE BEGIN 2 */
+#ifdef AD840X_BENCHMARK
+  // 基准测试固件（platformio.ini的env:benchmark）：跑完所有场景后停在这里
+  AD840X_Benchmark_Run();
+  while (1)
+  {
+  }
+#endif
 
   HAL_GPIO_WritePin(LED_GPIO_Port, LED_Pin, GPIO_PIN_SET); // 打开LED指示灯
+  // 按实际PCLK选择不超过10MHz的最快SPI时钟（72MHz下为9MHz）
+  AD840X_SPI_PlanClock(&hspi1, AD840X_SPI_MAX_CLOCK_HZ);
   // 初始化第一个AD840X数字电位器，使用完整引脚配置
   AD840X_Init(&hAD840X_1, &hspi1, AD840X_CS1_GPIO_Port, AD840X_CS1_Pin);                                          // 必要配置
   AD840X_Config_Pins(&hAD840X_1, AD840X_SHDN1_GPIO_Port, AD840X_SHDN1_Pin, AD840X_RS1_GPIO_Port, AD840X_RS1_Pin); // 可选配置
@@ -117,7 +128,7 @@ int main(void)
   // 设置初始值 - 使用新的函数，更直观地按电阻值设置
   AD840X_Write(&hAD840X_1, AD840X_CHANNEL_1, 128); // 设置为中间值（128）
   // 设置初始电阻值（更直观，直接使用欧姆值）
-  AD840X_WriteResistance(&hAD840X_1, AD840X_CHANNEL_1, 100.0f, AD840X_10K_OHM); // 设置为100Ω,程序会计算对应最近的值
+  AD840X_Write(&hAD840X_1, AD840X_CHANNEL_1, AD840X_RESISTANCE_CODE(100.0f, AD840X_10K_OHM)); // 设置为100Ω，编译时算出最近的值
 
   HAL_GPIO_WritePin(LED_GPIO_Port, LED_Pin, GPIO_PIN_SET); // 打开LED指示灯
   AD840X_Shutdown(&hAD840X_1, 0);                          // 将设备1设置为低功耗模式
@@ -191,6 +202,27 @@ void SystemClock_Config(void)
 
 /* USER CODE BEGIN 4 */
 
+/**
+ * @brief  SPI发送完成回调，DMA模式下由AD840X驱动拉高CS并发送下一帧
+ * @param  hspi: SPI句柄指针
+ * @retval None
+ */
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+  AD840X_SPI_TxCpltCallback(hspi);
+}
+
+/**
+ * @brief  SPI错误回调
+ * @param  hspi: SPI句柄指针
+ * @retval None
+ */
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+  AD840X_SPI_ErrorCallback(hspi);
+}
+
+
 /* USER CODE END 4 */
 
 /**
@@ -22,7 +22,8 @@
  * 说明在AD840X.h文件中，也可以看readme.md
  * 如果您需要在其他项目中使用这个AD840X驱动，只需：
  * 1. 在STM32CubeMX中配置SPI外设和GPIO引脚
- * 2. 拷贝AD840X.c和AD840X.h两个文件
+ * 2. 拷贝AD840X.c、AD840X_Transport.c、AD840X_Time.c和对应的AD840X.h、AD840X_Transport.h、AD840X_Time.h，
+ *    以及AD840X_Atomic.h（其余AD840X_*文件按需拷贝）
  * 3. 在您的代码中包含AD840X.h头文件（见第38行）
  * 4. 创建AD840X_HandleTypeDef结构体变量并调用AD840X_Init初始化（见第59行）
  * 5. 然后就可以自由使用AD840X_Write函数了
@@ -105,6 +106,8 @@ int main(void)
   /* USER CODE BEGIN 2 */
 
   HAL_GPIO_WritePin(LED_GPIO_Port, LED_Pin, GPIO_PIN_SET); // 打开LED指示灯
+  // 按实际PCLK选择不超过10MHz的最快SPI时钟（72MHz下为9MHz）
+  AD840X_SPI_PlanClock(&hspi1, AD840X_SPI_MAX_CLOCK_HZ);
   // 初始化第一个AD840X数字电位器，使用完整引脚配置
   AD840X_Init(&hAD840X_1, &hspi1, AD840X_CS1_GPIO_Port, AD840X_CS1_Pin);
   AD840X_Config_Pins(&hAD840X_1, AD840X_SHDN1_GPIO_Port, AD840X_SHDN1_Pin,
@@ -116,6 +119,7 @@ int main(void)
   // 初始化第三个AD840X数字电位器，但不配置SHDN和RS引脚
   // 注意：SHDN和RS引脚必须外部接高电平(VDD)以保证正常工作。运行到对应函数会触发警告
   AD840X_Init(&hAD840X_3, &hspi1, AD840X_CS3_GPIO_Port, AD840X_CS3_Pin);
+  AD840X_Config_Model(&hAD840X_3, AD840X_MODEL_AD8400); // 第三个设备是单通道AD8400，复位时只写通道1
   // 复位所有设备的通道到中间值（128）
   AD840X_Reset(&hAD840X_1); // 使用RS引脚复位
   AD840X_Reset(&hAD840X_2); // 使用RS引脚复位
@@ -232,6 +236,27 @@ void SystemClock_Config(void)
 
 /* USER CODE BEGIN 4 */
 
+/**
+ * @brief  SPI发送完成回调，DMA模式下由AD840X驱动拉高CS并发送下一帧
+ * @param  hspi: SPI句柄指针
+ * @retval None
+ */
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+  AD840X_SPI_TxCpltCallback(hspi);
+}
+
+/**
+ * @brief  SPI错误回调
+ * @param  hspi: SPI句柄指针
+ * @retval None
+ */
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+  AD840X_SPI_ErrorCallback(hspi);
+}
+
+
 /* USER CODE END 4 */
 
 /**
@@ -0,0 +1,74 @@
+/*
+ * AD840X系列数字电位器驱动库 - RTOS集成层（Linux pthread实现）
+ * 雪豹  编写
+ *
+ * 仿真中用pthread线程代替RTOS任务：互斥量对应pthread_mutex，
+ * 完成信号量用互斥量+条件变量实现成二值信号量，与FreeRTOS的xSemaphoreCreateBinary行为一致。
+ */
+#include "AD840X_OS.h"
+
+#ifdef AD840X_USE_RTOS
+
+#include <pthread.h>
+#include <stdlib.h>
+
+/* 二值信号量 */
+typedef struct
+{
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint8_t given;
+} AD840X_SimSemTypeDef;
+
+void AD840X_OS_BusInit(AD840X_BusTypeDef *bus)
+{
+    pthread_mutex_t *mutex = malloc(sizeof(pthread_mutex_t));
+    AD840X_SimSemTypeDef *sem = malloc(sizeof(AD840X_SimSemTypeDef));
+
+    if (mutex == NULL || sem == NULL)
+    {
+        Error_Handler();
+    }
+    pthread_mutex_init(mutex, NULL);
+    pthread_mutex_init(&sem->lock, NULL);
+    pthread_cond_init(&sem->cond, NULL);
+    sem->given = 0;
+
+    bus->os_mutex = mutex;
+    bus->os_signal = sem;
+}
+
+void AD840X_OS_BusLock(AD840X_BusTypeDef *bus)
+{
+    pthread_mutex_lock((pthread_mutex_t *)bus->os_mutex);
+}
+
+void AD840X_OS_BusUnlock(AD840X_BusTypeDef *bus)
+{
+    pthread_mutex_unlock((pthread_mutex_t *)bus->os_mutex);
+}
+
+void AD840X_OS_BusWait(AD840X_BusTypeDef *bus)
+{
+    AD840X_SimSemTypeDef *sem = (AD840X_SimSemTypeDef *)bus->os_signal;
+
+    pthread_mutex_lock(&sem->lock);
+    while (!sem->given)
+    {
+        pthread_cond_wait(&sem->cond, &sem->lock);
+    }
+    sem->given = 0;
+    pthread_mutex_unlock(&sem->lock);
+}
+
+void AD840X_OS_BusSignalFromISR(AD840X_BusTypeDef *bus)
+{
+    AD840X_SimSemTypeDef *sem = (AD840X_SimSemTypeDef *)bus->os_signal;
+
+    pthread_mutex_lock(&sem->lock);
+    sem->given = 1;
+    pthread_cond_signal(&sem->cond);
+    pthread_mutex_unlock(&sem->lock);
+}
+
+#endif /* AD840X_USE_RTOS */
@@ -0,0 +1,351 @@
+/*
+ * AD840X系列数字电位器驱动库 - Linux测试用传输后端
+ * 雪豹  编写
+ */
+#include <sched.h>
+#include "AD840X_Transport_Stub.h"
+#include "AD840X_Transport.h"
+
+#define AD840X_STUB_WORD_MASK 0x3FFU
+
+/**
+ * @brief  初始化仿真器件（上电状态：所有通道为中值）
+ * @param  stub: 仿真器件指针
+ * @retval None
+ */
+void AD840X_Stub_Init(AD840X_StubTypeDef *stub)
+{
+    stub->shift = 0;
+    stub->selected = 0;
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        stub->wiper[i] = AD840X_MIDSCALE;
+    }
+    stub->shutdown = 0;
+    stub->frames = 0;
+    stub->bits = 0;
+    stub->delay_ns = 0;
+    stub->corrupt_mask = 0;
+}
+
+/**
+ * @brief  移入一个字节，返回同时从SDO移出的字节
+ * @param  stub: 仿真器件指针
+ * @param  in: SDI上的字节
+ * @retval SDO上的字节
+ */
+static uint8_t AD840X_Stub_Shift(AD840X_StubTypeDef *stub, uint8_t in)
+{
+    uint8_t out = 0;
+
+    for (uint8_t bit = 0; bit < 8; bit++)
+    {
+        uint16_t sdi = (in >> (7U - bit)) & 1U;
+
+        /* 驱动每帧发送16位，按帧内位置注入错误 */
+        sdi ^= (stub->corrupt_mask >> (15U - (stub->bits & 0xFU))) & 1U;
+        out = (uint8_t)((out << 1) | ((stub->shift >> 9) & 1U));
+        stub->shift = (uint16_t)(((stub->shift << 1) | sdi) & AD840X_STUB_WORD_MASK);
+        stub->bits++;
+    }
+    return out;
+}
+
+/**
+ * @brief  改变CS电平
+ * @param  stub: 仿真器件指针
+ * @param  active: 1-拉低选中，0-拉高释放
+ */
+static void AD840X_Stub_SetCS(AD840X_StubTypeDef *stub, uint8_t active)
+{
+    if (!active && stub->selected)
+    {
+        /* CS上升沿把移位寄存器锁存到地址位指定的通道 */
+        stub->wiper[(stub->shift >> 8) & 0x3U] = (uint8_t)stub->shift;
+        stub->frames++;
+        stub->corrupt_mask = 0;
+    }
+    stub->selected = active;
+}
+
+static void AD840X_Stub_Select(AD840X_HandleTypeDef *hdev, uint8_t active)
+{
+    AD840X_Stub_SetCS((AD840X_StubTypeDef *)hdev->transport_ctx, active);
+}
+
+static HAL_StatusTypeDef AD840X_Stub_Transmit(AD840X_HandleTypeDef *hdev, const uint8_t *data, uint16_t size)
+{
+    AD840X_StubTypeDef *stub = (AD840X_StubTypeDef *)hdev->transport_ctx;
+
+    for (uint16_t i = 0; i < size; i++)
+    {
+        AD840X_Stub_Shift(stub, data[i]);
+    }
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef AD840X_Stub_TransmitReceive(AD840X_HandleTypeDef *hdev, const uint8_t *tx,
+                                                     uint8_t *rx, uint16_t size)
+{
+    AD840X_StubTypeDef *stub = (AD840X_StubTypeDef *)hdev->transport_ctx;
+
+    for (uint16_t i = 0; i < size; i++)
+    {
+        rx[i] = AD840X_Stub_Shift(stub, tx[i]);
+    }
+    return HAL_OK;
+}
+
+/**
+ * @brief  SHDN/RS引脚电平变化
+ * @param  stub: 仿真器件指针
+ * @param  hdev: AD840X设备句柄指针（用于区分引脚）
+ * @param  port: GPIO端口
+ * @param  pin: GPIO引脚
+ * @param  level: 1-高电平，0-低电平
+ */
+static void AD840X_Stub_SetPin(AD840X_StubTypeDef *stub, AD840X_HandleTypeDef *hdev, GPIO_TypeDef *port,
+                               uint16_t pin, uint8_t level)
+{
+    if (port == hdev->rs_port && pin == hdev->rs_pin && !level)
+    {
+        /* RS低电平把所有通道复位到中值（Page12） */
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            stub->wiper[i] = AD840X_MIDSCALE;
+        }
+    }
+    else if (port == hdev->shdn_port && pin == hdev->shdn_pin)
+    {
+        stub->shutdown = !level;
+    }
+}
+
+static void AD840X_Stub_PinWrite(AD840X_HandleTypeDef *hdev, GPIO_TypeDef *port, uint16_t pin, uint8_t level)
+{
+    AD840X_Stub_SetPin((AD840X_StubTypeDef *)hdev->transport_ctx, hdev, port, pin, level);
+}
+
+static void AD840X_Stub_Delay(AD840X_HandleTypeDef *hdev, uint32_t ns)
+{
+    AD840X_StubTypeDef *stub = (AD840X_StubTypeDef *)hdev->transport_ctx;
+
+    stub->delay_ns += ns;
+}
+
+const AD840X_TransportTypeDef AD840X_Transport_Stub = {
+    AD840X_Stub_Select,
+    AD840X_Stub_Transmit,
+    AD840X_Stub_TransmitReceive,
+    NULL,
+    AD840X_Stub_PinWrite,
+    AD840X_Stub_Delay,
+};
+
+/* ====================== 仿真SPI总线 ====================== */
+
+/**
+ * @brief  初始化仿真SPI总线
+ * @param  bus: 仿真总线指针
+ * @retval None
+ */
+void AD840X_StubBus_Init(AD840X_StubBusTypeDef *bus)
+{
+    bus->num_devices = 0;
+    bus->collisions = 0;
+    bus->dma_data = NULL;
+    bus->dma_size = 0;
+    bus->dma_frames = 0;
+    bus->dma_fail_every = 0;
+    bus->dma_failed = 0;
+}
+
+/**
+ * @brief  把仿真器件挂到总线上
+ * @param  bus: 仿真总线指针
+ * @param  stub: 仿真器件指针
+ * @param  cs_pin: 该器件的CS引脚（与设备句柄的cs_pin相同）
+ * @retval None
+ */
+void AD840X_StubBus_Attach(AD840X_StubBusTypeDef *bus, AD840X_StubTypeDef *stub, uint16_t cs_pin)
+{
+    if (bus->num_devices < AD840X_STUB_BUS_DEVICES)
+    {
+        bus->dev[bus->num_devices] = stub;
+        bus->cs_pin[bus->num_devices] = cs_pin;
+        bus->num_devices++;
+    }
+}
+
+/**
+ * @brief  按CS引脚找到设备句柄对应的仿真器件
+ * @param  hdev: AD840X设备句柄指针
+ * @retval 仿真器件指针，未挂到总线上时为NULL
+ */
+static AD840X_StubTypeDef *AD840X_StubBus_Device(AD840X_HandleTypeDef *hdev)
+{
+    AD840X_StubBusTypeDef *bus = (AD840X_StubBusTypeDef *)hdev->transport_ctx;
+
+    for (uint8_t i = 0; i < bus->num_devices; i++)
+    {
+        if (bus->cs_pin[i] == hdev->cs_pin)
+        {
+            return bus->dev[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief  在共用的SCK/SDI上移入一个字节，所有被选中的器件都会收到
+ * @param  bus: 仿真总线指针
+ * @param  in: SDI上的字节
+ * @retval 唯一被选中器件的SDO字节，其他情况为0
+ */
+static uint8_t AD840X_StubBus_Shift(AD840X_StubBusTypeDef *bus, uint8_t in)
+{
+    uint8_t selected = 0;
+    uint8_t out = 0;
+
+    for (uint8_t i = 0; i < bus->num_devices; i++)
+    {
+        if (bus->dev[i]->selected)
+        {
+            selected++;
+            out = AD840X_Stub_Shift(bus->dev[i], in);
+        }
+    }
+    if (selected != 1)
+    {
+        bus->collisions++;
+        return 0;
+    }
+    return out;
+}
+
+static void AD840X_StubBus_Select(AD840X_HandleTypeDef *hdev, uint8_t active)
+{
+    AD840X_StubTypeDef *stub = AD840X_StubBus_Device(hdev);
+
+    if (stub != NULL)
+    {
+        AD840X_Stub_SetCS(stub, active);
+    }
+}
+
+static HAL_StatusTypeDef AD840X_StubBus_Transmit(AD840X_HandleTypeDef *hdev, const uint8_t *data, uint16_t size)
+{
+    AD840X_StubBusTypeDef *bus = (AD840X_StubBusTypeDef *)hdev->transport_ctx;
+
+    for (uint16_t i = 0; i < size; i++)
+    {
+        AD840X_StubBus_Shift(bus, data[i]);
+        sched_yield(); // 让出CPU，扩大多线程交错的窗口
+    }
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef AD840X_StubBus_TransmitReceive(AD840X_HandleTypeDef *hdev, const uint8_t *tx,
+                                                        uint8_t *rx, uint16_t size)
+{
+    AD840X_StubBusTypeDef *bus = (AD840X_StubBusTypeDef *)hdev->transport_ctx;
+
+    for (uint16_t i = 0; i < size; i++)
+    {
+        rx[i] = AD840X_StubBus_Shift(bus, tx[i]);
+        sched_yield();
+    }
+    return HAL_OK;
+}
+
+/* 启动DMA：只记录数据，由AD840X_StubBus_RunDMA在扮演中断的线程中完成 */
+static HAL_StatusTypeDef AD840X_StubBus_Transmit_DMA(AD840X_HandleTypeDef *hdev, const uint8_t *data,
+                                                     uint16_t size)
+{
+    AD840X_StubBusTypeDef *bus = (AD840X_StubBusTypeDef *)hdev->transport_ctx;
+
+    if (bus->dma_data != NULL)
+    {
+        bus->collisions++; // 上一次DMA还没完成就启动了新的
+    }
+    bus->dma_size = size;
+    __DMB();
+    bus->dma_data = data;
+    return HAL_OK;
+}
+
+static void AD840X_StubBus_PinWrite(AD840X_HandleTypeDef *hdev, GPIO_TypeDef *port, uint16_t pin, uint8_t level)
+{
+    AD840X_StubTypeDef *stub = AD840X_StubBus_Device(hdev);
+
+    if (stub != NULL)
+    {
+        AD840X_Stub_SetPin(stub, hdev, port, pin, level);
+    }
+}
+
+static void AD840X_StubBus_Delay(AD840X_HandleTypeDef *hdev, uint32_t ns)
+{
+    AD840X_StubTypeDef *stub = AD840X_StubBus_Device(hdev);
+
+    if (stub != NULL)
+    {
+        stub->delay_ns += ns;
+    }
+}
+
+/**
+ * @brief  完成正在进行的DMA传输并进入完成中断
+ * @param  bus: 仿真总线指针
+ * @note   在扮演中断的线程中循环调用
+ * @retval 1-完成了一次传输，0-没有进行中的传输
+ */
+uint8_t AD840X_StubBus_RunDMA(AD840X_StubBusTypeDef *bus)
+{
+    const uint8_t *data = bus->dma_data;
+
+    if (data == NULL)
+    {
+        return 0;
+    }
+    __DMB();
+
+    /* 中断期间任务线程不能进入关中断的临界区 */
+    __disable_irq();
+    bus->dma_frames++;
+    bus->dma_data = NULL; // 完成中断中可能启动下一帧
+    if (bus->dma_fail_every != 0U && bus->dma_frames % bus->dma_fail_every == 0U)
+    {
+        /* 传输出错：数据没有移出，进入出错中断 */
+        bus->dma_failed++;
+        AD840X_Transport_TxError(bus);
+    }
+    else
+    {
+        for (uint16_t i = 0; i < bus->dma_size; i++)
+        {
+            AD840X_StubBus_Shift(bus, data[i]);
+        }
+        AD840X_Transport_TxComplete(bus);
+    }
+    __enable_irq();
+    return 1;
+}
+
+const AD840X_TransportTypeDef AD840X_Transport_StubBus = {
+    AD840X_StubBus_Select,
+    AD840X_StubBus_Transmit,
+    AD840X_StubBus_TransmitReceive,
+    NULL,
+    AD840X_StubBus_PinWrite,
+    AD840X_StubBus_Delay,
+};
+
+const AD840X_TransportTypeDef AD840X_Transport_StubBus_DMA = {
+    AD840X_StubBus_Select,
+    AD840X_StubBus_Transmit,
+    AD840X_StubBus_TransmitReceive,
+    AD840X_StubBus_Transmit_DMA,
+    AD840X_StubBus_PinWrite,
+    AD840X_StubBus_Delay,
+};
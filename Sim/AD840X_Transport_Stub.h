@@ -0,0 +1,93 @@
+/*
+ * AD840X系列数字电位器驱动库 - Linux测试用传输后端
+ * 雪豹  编写   github.com/2827700630
+ *
+ * 每个设备句柄的transport_ctx指向一个AD840X_StubTypeDef，它按数据手册模拟一片AD840X：
+ * 10位移位寄存器在CS上升沿锁存到对应通道（Page10 Figure3），SDO移出寄存器最高位
+ * （Page22 Figure50），RS低电平复位到中值，SHDN低电平断电。
+ * 可以在Linux上运行真实的AD840X.c，检查每个通道最终的值和帧数。
+ *
+ * AD840X_StubBusTypeDef模拟多片器件共用SCK/SDI、各自一根CS的SPI总线，
+ * 同一总线上的设备共用一个transport_ctx，可以检查多任务访问时CS帧是否交错，
+ * 并提供一个异步完成的DMA，由扮演中断的线程调用AD840X_StubBus_RunDMA。
+ */
+
+#ifndef __AD840X_TRANSPORT_STUB_H
+#define __AD840X_TRANSPORT_STUB_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "AD840X.h"
+
+    /* 仿真器件 */
+    typedef struct
+    {
+        uint16_t shift;        // 10位移位寄存器
+        uint8_t selected;      // CS是否为低
+        uint8_t wiper[4];      // 各通道锁存值
+        uint8_t shutdown;      // SHDN是否为低
+        uint32_t frames;       // CS上升沿锁存次数
+        uint32_t bits;         // 移入的总位数
+        uint64_t delay_ns;     // 驱动请求的累计延时
+        uint16_t corrupt_mask; // 故障注入：下一帧（16位）中要翻转的SDI位，锁存后清零
+    } AD840X_StubTypeDef;
+
+    /* 仿真SPI总线上最多的器件数 */
+#define AD840X_STUB_BUS_DEVICES 4
+
+    /* 仿真SPI总线 */
+    typedef struct
+    {
+        AD840X_StubTypeDef *dev[AD840X_STUB_BUS_DEVICES]; // 挂在总线上的仿真器件
+        uint16_t cs_pin[AD840X_STUB_BUS_DEVICES];         // 各器件的CS引脚
+        uint8_t num_devices;                              // 器件数
+        uint32_t collisions;                              // 有时钟时被选中的器件不是恰好一片的次数
+        const uint8_t *volatile dma_data;                 // 已启动、尚未完成的DMA数据，没有时为NULL
+        volatile uint16_t dma_size;                       // DMA字节数
+        uint32_t dma_frames;                              // 已完成（含出错）的DMA传输次数
+        uint32_t dma_fail_every;                          // 故障注入：每N次DMA传输有1次出错，0为不注入
+        uint32_t dma_failed;                              // 注入的出错次数
+    } AD840X_StubBusTypeDef;
+
+    extern const AD840X_TransportTypeDef AD840X_Transport_Stub;
+    extern const AD840X_TransportTypeDef AD840X_Transport_StubBus;
+    extern const AD840X_TransportTypeDef AD840X_Transport_StubBus_DMA;
+
+    /**
+     * @brief  初始化仿真器件（上电状态：所有通道为中值）
+     * @param  stub: 仿真器件指针
+     * @retval None
+     */
+    void AD840X_Stub_Init(AD840X_StubTypeDef *stub);
+
+    /**
+     * @brief  初始化仿真SPI总线
+     * @param  bus: 仿真总线指针
+     * @retval None
+     */
+    void AD840X_StubBus_Init(AD840X_StubBusTypeDef *bus);
+
+    /**
+     * @brief  把仿真器件挂到总线上
+     * @param  bus: 仿真总线指针
+     * @param  stub: 仿真器件指针
+     * @param  cs_pin: 该器件的CS引脚（与设备句柄的cs_pin相同）
+     * @retval None
+     */
+    void AD840X_StubBus_Attach(AD840X_StubBusTypeDef *bus, AD840X_StubTypeDef *stub, uint16_t cs_pin);
+
+    /**
+     * @brief  完成正在进行的DMA传输并进入完成中断
+     * @param  bus: 仿真总线指针
+     * @note   在扮演中断的线程中循环调用
+     * @retval 1-完成了一次传输，0-没有进行中的传输
+     */
+    uint8_t AD840X_StubBus_RunDMA(AD840X_StubBusTypeDef *bus);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __AD840X_TRANSPORT_STUB_H */
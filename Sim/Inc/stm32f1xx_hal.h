@@ -0,0 +1,210 @@
+/*
+ * AD840X系列数字电位器驱动库 - Linux仿真用HAL库替身
+ * 雪豹  编写   github.com/2827700630
+ *
+ * 只提供驱动用到的类型、寄存器和函数声明，函数实现见Sim/sim_hal.c。
+ * 编译时把Sim/Inc放在Core/Inc之后的包含路径中，CubeMX生成的main.h、spi.h
+ * 会原样使用，其中的#include "stm32f1xx_hal.h"解析到本文件。
+ */
+
+#ifndef __STM32F1xx_HAL_H
+#define __STM32F1xx_HAL_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* 与Core/Inc/stm32f1xx_hal_conf.h一致，仿真中提供HAL SPI句柄 */
+#define HAL_SPI_MODULE_ENABLED
+
+/* ====================== 基本类型 ====================== */
+
+typedef enum
+{
+    HAL_OK = 0x00U,
+    HAL_ERROR = 0x01U,
+    HAL_BUSY = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+    GPIO_PIN_RESET = 0U,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+#define HAL_MAX_DELAY 0xFFFFFFFFU
+
+/* ====================== 寄存器 ====================== */
+
+typedef struct
+{
+    volatile uint32_t CRL;
+    volatile uint32_t CRH;
+    volatile uint32_t IDR;
+    volatile uint32_t ODR;
+    volatile uint32_t BSRR;
+    volatile uint32_t BRR;
+    volatile uint32_t LCKR;
+} GPIO_TypeDef;
+
+typedef struct
+{
+    volatile uint32_t CR1;
+    volatile uint32_t CR2;
+    volatile uint32_t SR;
+    volatile uint32_t DR;
+    volatile uint32_t CRCPR;
+    volatile uint32_t RXCRCR;
+    volatile uint32_t TXCRCR;
+    volatile uint32_t I2SCFGR;
+} SPI_TypeDef;
+
+typedef struct
+{
+    volatile uint32_t CCR;
+    volatile uint32_t CNDTR;
+    volatile uint32_t CPAR;
+    volatile uint32_t CMAR;
+} DMA_Channel_TypeDef;
+
+typedef struct
+{
+    volatile uint32_t CR;
+    volatile uint32_t CFGR;
+    volatile uint32_t CIR;
+    volatile uint32_t APB2RSTR;
+    volatile uint32_t APB1RSTR;
+    volatile uint32_t AHBENR;
+    volatile uint32_t APB2ENR;
+    volatile uint32_t APB1ENR;
+    volatile uint32_t BDCR;
+    volatile uint32_t CSR;
+} RCC_TypeDef;
+
+extern GPIO_TypeDef sim_gpio[3];
+extern SPI_TypeDef sim_spi[2];
+extern DMA_Channel_TypeDef sim_dma1_channel[7];
+extern RCC_TypeDef sim_rcc;
+
+#define GPIOA (&sim_gpio[0])
+#define GPIOB (&sim_gpio[1])
+#define GPIOC (&sim_gpio[2])
+#define SPI1 (&sim_spi[0])
+#define SPI2 (&sim_spi[1])
+#define DMA1_Channel3 (&sim_dma1_channel[2])
+#define DMA1_Channel5 (&sim_dma1_channel[4])
+#define RCC (&sim_rcc)
+
+#define GPIO_PIN_0 ((uint16_t)0x0001)
+#define GPIO_PIN_1 ((uint16_t)0x0002)
+#define GPIO_PIN_2 ((uint16_t)0x0004)
+#define GPIO_PIN_3 ((uint16_t)0x0008)
+#define GPIO_PIN_4 ((uint16_t)0x0010)
+#define GPIO_PIN_5 ((uint16_t)0x0020)
+#define GPIO_PIN_6 ((uint16_t)0x0040)
+#define GPIO_PIN_7 ((uint16_t)0x0080)
+#define GPIO_PIN_8 ((uint16_t)0x0100)
+#define GPIO_PIN_9 ((uint16_t)0x0200)
+#define GPIO_PIN_10 ((uint16_t)0x0400)
+#define GPIO_PIN_11 ((uint16_t)0x0800)
+#define GPIO_PIN_12 ((uint16_t)0x1000)
+#define GPIO_PIN_13 ((uint16_t)0x2000)
+#define GPIO_PIN_14 ((uint16_t)0x4000)
+#define GPIO_PIN_15 ((uint16_t)0x8000)
+
+#define SPI_CR1_SPE (1UL << 6)
+#define SPI_CR1_BR_Pos 3U
+#define SPI_CR1_BR (0x7UL << SPI_CR1_BR_Pos)
+#define SPI_CR2_TXDMAEN (1UL << 1)
+#define DMA_CCR_EN (1UL << 0)
+#define RCC_AHBENR_DMA1EN (1UL << 0)
+#define RCC_APB2ENR_SPI1EN (1UL << 12)
+#define RCC_APB1ENR_SPI2EN (1UL << 14)
+#define SPI_SR_RXNE (1UL << 0)
+#define SPI_SR_TXE (1UL << 1)
+#define SPI_SR_OVR (1UL << 6)
+#define SPI_SR_BSY (1UL << 7)
+
+#define SET_BIT(REG, BIT) ((REG) |= (BIT))
+#define READ_REG(REG) ((REG))
+#define WRITE_REG(REG, VAL) ((REG) = (VAL))
+#define MODIFY_REG(REG, CLEARMASK, SETMASK) WRITE_REG((REG), (((READ_REG(REG)) & (~(CLEARMASK))) | (SETMASK)))
+
+/* ====================== SPI ====================== */
+
+typedef struct
+{
+    uint32_t Mode;
+    uint32_t Direction;
+    uint32_t DataSize;
+    uint32_t CLKPolarity;
+    uint32_t CLKPhase;
+    uint32_t NSS;
+    uint32_t BaudRatePrescaler;
+    uint32_t FirstBit;
+} SPI_InitTypeDef;
+
+typedef struct
+{
+    void *Parent;
+} DMA_HandleTypeDef;
+
+typedef struct __SPI_HandleTypeDef
+{
+    SPI_TypeDef *Instance;
+    SPI_InitTypeDef Init;
+    DMA_HandleTypeDef *hdmatx;
+    DMA_HandleTypeDef *hdmarx;
+} SPI_HandleTypeDef;
+
+#define SPI_DIRECTION_2LINES 0x00000000U
+#define SPI_DIRECTION_1LINE 0x00008000U
+#define SPI_FLAG_BSY SPI_SR_BSY
+
+#define __HAL_SPI_GET_FLAG(__HANDLE__, __FLAG__) ((((__HANDLE__)->Instance->SR) & (__FLAG__)) == (__FLAG__))
+#define __HAL_SPI_DISABLE(__HANDLE__) ((__HANDLE__)->Instance->CR1 &= ~SPI_CR1_SPE)
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData,
+                                          uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size);
+
+/* ====================== GPIO/RCC/系统 ====================== */
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void HAL_Delay(uint32_t Delay);
+uint32_t HAL_GetTick(void);
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+uint32_t HAL_RCC_GetPCLK2Freq(void);
+
+extern uint32_t SystemCoreClock;
+
+/* 没有DWT：驱动的微秒计时（AD840X_Time.h）改用主机单调时钟换算的周期数 */
+uint32_t Sim_Cycles(void);
+#define AD840X_TIME_NOW() Sim_Cycles()
+
+/* 没有ITM：遥测数据包（AD840X_ITM.h）按SWO格式写入Sim_SWO_Open打开的文件，没有打开时丢弃 */
+int Sim_SWO_Open(const char *path);
+void Sim_ITM_Write(uint32_t port, uint32_t word);
+#define AD840X_ITM_ENABLED(port) (1)
+#define AD840X_ITM_FIFO_READY(port) (1)
+#define AD840X_ITM_WRITE(port, word) Sim_ITM_Write(port, word)
+
+/* 中断屏蔽用一个全局锁模拟：仿真中扮演中断的线程在持有该锁时运行，
+ * 任务线程关中断期间中断线程不会插进来。单线程程序中相当于空操作 */
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t primask);
+void __disable_irq(void);
+void __enable_irq(void);
+#define __DMB() __sync_synchronize()
+#define __NOP() ((void)0)
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __STM32F1xx_HAL_H */
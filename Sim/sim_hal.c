@@ -0,0 +1,178 @@
+/*
+ * AD840X系列数字电位器驱动库 - Linux仿真用HAL库替身
+ * 雪豹  编写
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include "main.h"
+#include "spi.h"
+#include "sim_pins.h"
+
+GPIO_TypeDef sim_gpio[3];
+
+/* SR中TXE、RXNE常为1，BSY常为0，直接访问寄存器的后端不会卡住 */
+SPI_TypeDef sim_spi[2] = {
+    {.CR1 = 1U << SPI_CR1_BR_Pos, .SR = SPI_SR_TXE | SPI_SR_RXNE},
+    {.CR1 = 1U << SPI_CR1_BR_Pos, .SR = SPI_SR_TXE | SPI_SR_RXNE},
+};
+
+DMA_Channel_TypeDef sim_dma1_channel[7];
+RCC_TypeDef sim_rcc;
+
+/* 与CubeMX配置一致：SPI1全双工主机，4分频 */
+SPI_HandleTypeDef hspi1 = {SPI1, {0, SPI_DIRECTION_2LINES, 0, 0, 0, 0, 1U << SPI_CR1_BR_Pos, 0}, NULL, NULL};
+
+uint32_t SystemCoreClock = 72000000U;
+
+static uint32_t sim_tick;
+static FILE *sim_swo;
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    if (PinState == GPIO_PIN_SET)
+    {
+        GPIOx->ODR |= GPIO_Pin;
+    }
+    else
+    {
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    }
+    Sim_Pins_Gpio(GPIOx, GPIO_Pin, PinState == GPIO_PIN_SET);
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)Timeout;
+    Sim_Pins_Spi(hspi, pData, Size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData,
+                                          uint16_t Size, uint32_t Timeout)
+{
+    (void)Timeout;
+    Sim_Pins_Spi(hspi, pTxData, Size);
+    for (uint16_t i = 0; i < Size; i++)
+    {
+        pRxData[i] = 0;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size)
+{
+    (void)hspi;
+    (void)pData;
+    (void)Size;
+    return HAL_OK;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    sim_tick += Delay;
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return sim_tick;
+}
+
+uint32_t Sim_Cycles(void)
+{
+    struct timespec ts;
+    uint32_t cycles;
+
+    /* 引脚级模型记录期间使用虚拟时间（见sim_pins.h） */
+    if (Sim_Pins_Cycles(&cycles))
+    {
+        return cycles;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec) * (SystemCoreClock / 1000000U) /
+                      1000U);
+}
+
+int Sim_SWO_Open(const char *path)
+{
+    /* 同步包（至少47个0后跟一个1），真实的SWO数据流也以它开头 */
+    static const uint8_t sync[6] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x80};
+
+    sim_swo = fopen(path, "wb");
+    if (sim_swo == NULL)
+    {
+        return -1;
+    }
+    fwrite(sync, 1, sizeof(sync), sim_swo);
+    return 0;
+}
+
+void Sim_ITM_Write(uint32_t port, uint32_t word)
+{
+    /* 激励端口包：头字节为端口号<<3，低2位0b11表示4字节负载，负载小端 */
+    uint8_t packet[5] = {(uint8_t)((port << 3) | 0x03U), (uint8_t)word, (uint8_t)(word >> 8),
+                         (uint8_t)(word >> 16), (uint8_t)(word >> 24)};
+
+    if (sim_swo != NULL)
+    {
+        fwrite(packet, 1, sizeof(packet), sim_swo);
+        fflush(sim_swo); // 解码脚本可以同时读取（tail -f、命名管道）
+    }
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void)
+{
+    return SystemCoreClock / 2U; // APB1 = HCLK/2
+}
+
+uint32_t HAL_RCC_GetPCLK2Freq(void)
+{
+    return SystemCoreClock; // APB2 = HCLK
+}
+
+/* 模拟PRIMASK：每个线程各自的屏蔽状态，屏蔽期间持有全局中断锁 */
+static pthread_mutex_t sim_irq_lock = PTHREAD_MUTEX_INITIALIZER;
+static __thread uint32_t sim_primask;
+
+uint32_t __get_PRIMASK(void)
+{
+    return sim_primask;
+}
+
+void __disable_irq(void)
+{
+    if (!sim_primask)
+    {
+        pthread_mutex_lock(&sim_irq_lock);
+        sim_primask = 1;
+    }
+}
+
+void __enable_irq(void)
+{
+    if (sim_primask)
+    {
+        sim_primask = 0;
+        pthread_mutex_unlock(&sim_irq_lock);
+    }
+}
+
+void __set_PRIMASK(uint32_t primask)
+{
+    if (primask)
+    {
+        __disable_irq();
+    }
+    else
+    {
+        __enable_irq();
+    }
+}
+
+void Error_Handler(void)
+{
+    fprintf(stderr, "Error_Handler\n");
+    abort();
+}
@@ -0,0 +1,158 @@
+/*
+ * AD840X系列数字电位器驱动库 - Linux仿真示例
+ * 雪豹  编写
+ *
+ * 用Linux测试用传输后端运行真实的AD840X.c，打印各仿真器件的通道值。
+ * 编译运行方法见Sim/README.md
+ */
+#include <stdio.h>
+#include "AD840X.h"
+#include "AD840X_Transport.h"
+#include "AD840X_Transport_Stub.h"
+#include "AD840X_Time.h"
+#include "AD840X_Stop.h"
+#include "AD840X_Trace.h"
+#include "AD840X_ITM.h"
+
+#ifdef AD840X_USE_TRACE
+static void print_line(const char *line)
+{
+    fputs(line, stdout);
+}
+#endif
+
+static void print_stub(const char *name, const AD840X_StubTypeDef *stub)
+{
+    printf("%-6s wiper = %3u %3u %3u %3u  frames = %u  shutdown = %u\n", name,
+           stub->wiper[0], stub->wiper[1], stub->wiper[2], stub->wiper[3],
+           (unsigned)stub->frames, stub->shutdown);
+}
+
+int main(void)
+{
+    AD840X_StubTypeDef stub_1, stub_2;
+    AD840X_HandleTypeDef hAD840X_1, hAD840X_2;
+
+    AD840X_Stub_Init(&stub_1);
+    AD840X_Stub_Init(&stub_2);
+
+#ifdef AD840X_USE_ITM
+    /* ITM遥测写到文件，解码：python3 Tools/ad840x_itm_decode.py ad840x.swo */
+    if (Sim_SWO_Open("ad840x.swo") != 0)
+    {
+        perror("ad840x.swo");
+    }
+#endif
+
+    /* 设备1：AD8403，SHDN和RS接到单片机 */
+    AD840X_Init_Transport(&hAD840X_1, &AD840X_Transport_Stub, &stub_1, AD840X_CS1_GPIO_Port, AD840X_CS1_Pin);
+    AD840X_Config_Pins(&hAD840X_1, AD840X_SHDN1_GPIO_Port, AD840X_SHDN1_Pin, AD840X_RS1_GPIO_Port, AD840X_RS1_Pin);
+
+    /* 设备2：AD8400，只有通道1 */
+    AD840X_Init_Transport(&hAD840X_2, &AD840X_Transport_Stub, &stub_2, AD840X_CS2_GPIO_Port, AD840X_CS2_Pin);
+    AD840X_Config_Model(&hAD840X_2, AD840X_MODEL_AD8400);
+
+    AD840X_Write(&hAD840X_1, AD840X_CHANNEL_1, 10);
+    AD840X_Write(&hAD840X_1, AD840X_CHANNEL_4, 200);
+    AD840X_WriteRatio(&hAD840X_2, AD840X_CHANNEL_1, 0.25f);
+    AD840X_Write(&hAD840X_2, AD840X_CHANNEL_3, 99); // AD8400没有通道3，不会发送
+    print_stub("dev1", &stub_1);
+    print_stub("dev2", &stub_2);
+
+    AD840X_Reset(&hAD840X_1); // RS引脚复位
+    AD840X_Reset(&hAD840X_2); // SPI写中值，只写1帧
+    print_stub("dev1", &stub_1);
+    print_stub("dev2", &stub_2);
+
+    /* 回读校验：在通道3的数据最低位注入1位错误，驱动在下一帧检测到并重试 */
+    AD840X_Config_Verify(&hAD840X_1, 1, 2);
+    AD840X_Write(&hAD840X_1, AD840X_CHANNEL_2, 0x11);
+    stub_1.corrupt_mask = 0x0001;
+    AD840X_Write(&hAD840X_1, AD840X_CHANNEL_3, 0x22);
+    AD840X_Write(&hAD840X_1, AD840X_CHANNEL_4, 0x33);
+    print_stub("dev1", &stub_1);
+    printf("verify_errors = %u  verify_retry_count = %u\n",
+           (unsigned)hAD840X_1.verify_errors, (unsigned)hAD840X_1.verify_retry_count);
+
+    AD840X_Shutdown(&hAD840X_1, 0);
+    AD840X_Shutdown(&hAD840X_1, 1);
+    printf("delay requested = %llu ns\n", (unsigned long long)stub_1.delay_ns);
+
+    /* 空闲自动断电：100ms无写入后断电，下一次写入自动唤醒并等待ts */
+    AD840X_HandleTypeDef *const devs[] = {&hAD840X_1, &hAD840X_2};
+    AD840X_Config_AutoShutdown(&hAD840X_1, 100);
+    AD840X_Config_AutoShutdown(&hAD840X_2, 100); // 没有SHDN引脚，不启用
+    HAL_Delay(99);
+    printf("auto shutdown after 99ms: entered = %u", AD840X_AutoShutdown_Process(devs, 2));
+    HAL_Delay(1);
+    printf(", after 100ms: entered = %u", AD840X_AutoShutdown_Process(devs, 2));
+    printf("  shutdown = %u\n", stub_1.shutdown);
+    stub_1.delay_ns = 0;
+    AD840X_Write(&hAD840X_1, AD840X_CHANNEL_1, 77);
+    print_stub("dev1", &stub_1);
+    printf("wakeups = %u  delay before write = %llu ns\n", (unsigned)hAD840X_1.wakeups,
+           (unsigned long long)stub_1.delay_ns);
+
+    /* 复位后恢复：RS复位让所有通道回到中值，AD840X_Restore只重发不是中值的通道 */
+    AD840X_Write(&hAD840X_1, AD840X_CHANNEL_2, AD840X_MIDSCALE);
+    AD840X_Reset(&hAD840X_1);
+    print_stub("dev1", &stub_1);
+    uint16_t restored = 0;
+    AD840X_Restore(devs, 2, 1, &restored);
+    print_stub("dev1", &stub_1);
+    print_stub("dev2", &stub_2);
+    printf("restored frames = %u\n", restored);
+
+    /* STOP模式：挂起期间的写入只记录，唤醒后每通道补发最后一次的值；
+     * 模拟唤醒后SPI和DMA配置被清零，AD840X_Resume直接写回寄存器 */
+    AD840X_StopTypeDef stop;
+    AD840X_Stop_Init(&stop, SPI1, DMA1_Channel3);
+    SPI1->CR1 |= SPI_CR1_SPE;
+    SPI1->CR2 = SPI_CR2_TXDMAEN;
+    DMA1_Channel3->CCR = 0x3092U;
+    DMA1_Channel3->CPAR = 0x4001300CU;
+    uint32_t frames_before = stub_1.frames;
+    AD840X_Suspend(&stop, 1);
+    AD840X_Write(&hAD840X_1, AD840X_CHANNEL_1, 5);
+    AD840X_Write(&hAD840X_1, AD840X_CHANNEL_1, 6);
+    AD840X_Write(&hAD840X_1, AD840X_CHANNEL_3, 7);
+    printf("frames sent while suspended = %u\n", (unsigned)(stub_1.frames - frames_before));
+    uint32_t cr1 = SPI1->CR1;
+    SPI1->CR1 = 0;
+    SPI1->CR2 = 0;
+    DMA1_Channel3->CCR = 0;
+    uint16_t resumed = AD840X_Resume(&stop, 1, devs, 2);
+    print_stub("dev1", &stub_1);
+    printf("resume frames = %u  reloads = %u  registers restored: %s\n", resumed, (unsigned)stop.reloads,
+           (SPI1->CR1 == cr1 && SPI1->CR2 == SPI_CR2_TXDMAEN && DMA1_Channel3->CCR == 0x3092U) ? "ok" : "FAILED");
+
+    /* 跳过重复写入：器件中已经是这个值时不发送；复位后第一次写入一定发送 */
+    AD840X_Config_SkipRedundant(&hAD840X_1, 1);
+    frames_before = stub_1.frames;
+    AD840X_Write(&hAD840X_1, AD840X_CHANNEL_1, 6);
+    AD840X_Write(&hAD840X_1, AD840X_CHANNEL_1, 8);
+    AD840X_Write(&hAD840X_1, AD840X_CHANNEL_1, 8);
+    AD840X_Reset(&hAD840X_1);
+    AD840X_Write(&hAD840X_1, AD840X_CHANNEL_1, 8);
+    printf("skip redundant: frames sent = %u (expected 2)\n", (unsigned)(stub_1.frames - frames_before));
+
+    AD840X_StatsTypeDef stats;
+    AD840X_GetStats(&hAD840X_1, &stats);
+    printf("stats: frames = %u  bytes = %u  skipped = %u  errors = %u  retries = %u  shutdown = %u ms\n",
+           (unsigned)stats.frames, (unsigned)stats.bytes, (unsigned)stats.skipped, (unsigned)stats.errors,
+           (unsigned)stats.retries, (unsigned)stats.shutdown_ms);
+
+    /* 微秒计时：仿真中由主机单调时钟代替DWT */
+    uint32_t start = AD840X_Time_Now();
+    AD840X_Time_DelayUs(100);
+    printf("DelayUs(100) >= 100us: %s\n", AD840X_Time_ToUs(AD840X_Time_Now() - start) >= 100U ? "ok" : "FAILED");
+
+#ifdef AD840X_USE_TRACE
+    /* 命令跟踪：输出最近的记录（编译时加-DAD840X_USE_TRACE） */
+    AD840X_Trace_Dump(print_line);
+#endif
+#ifdef AD840X_USE_ITM
+    printf("ITM packets written to ad840x.swo, dropped = %u\n", (unsigned)AD840X_ITM_Dropped());
+#endif
+    return 0;
+}
@@ -0,0 +1,476 @@
+/*
+ * AD840X系列数字电位器驱动库 - Linux仿真用引脚级总线模型
+ * 雪豹  编写
+ */
+#include <stdio.h>
+#include "sim_pins.h"
+
+const Sim_PinsCostTypeDef Sim_Pins_CostHAL = {111, 1389, 417, 56};
+const Sim_PinsCostTypeDef Sim_Pins_CostFast = {14, 14, 14, 14};
+
+static Sim_PinTypeDef sim_sig[SIM_PINS_SIGNALS];
+static uint8_t sim_num_sig;
+static uint8_t sim_start_level[SIM_PINS_SIGNALS]; // Sim_Pins_Start时各信号的电平
+static Sim_PinEventTypeDef sim_ev[SIM_PINS_EVENTS];
+static uint32_t sim_num_ev;
+static uint32_t sim_lost; // 记录已满后丢弃的电平变化
+static uint8_t sim_active;
+static uint64_t sim_now;  // 虚拟时间（ns）
+static Sim_PinsCostTypeDef sim_cost;
+
+/**
+ * @brief  添加一个信号
+ * @retval 信号序号，表满时为-1
+ */
+static int sim_pins_add(const char *name, Sim_PinRoleTypeDef role, GPIO_TypeDef *port, uint16_t pin,
+                        SPI_TypeDef *spi)
+{
+    Sim_PinTypeDef *s;
+
+    if (sim_num_sig >= SIM_PINS_SIGNALS)
+    {
+        return -1;
+    }
+    s = &sim_sig[sim_num_sig];
+    s->name = name;
+    s->role = role;
+    s->port = port;
+    s->pin = pin;
+    s->spi = spi;
+    s->level = (port != NULL) ? ((port->ODR & pin) != 0U) : 0U;
+    return sim_num_sig++;
+}
+
+/**
+ * @brief  添加一个GPIO信号（CS、RS、SHDN）
+ * @param  name: 显示名称
+ * @param  role: 信号类型
+ * @param  port: GPIO端口
+ * @param  pin: GPIO引脚
+ * @param  spi: CS所在的SPI总线，RS/SHDN传NULL
+ * @retval 信号序号，表满时为-1
+ */
+int Sim_Pins_AddGpio(const char *name, Sim_PinRoleTypeDef role, GPIO_TypeDef *port, uint16_t pin,
+                     SPI_TypeDef *spi)
+{
+    return sim_pins_add(name, role, port, pin, spi);
+}
+
+/**
+ * @brief  添加一条SPI总线的SCK和SDI信号
+ * @param  sck_name: SCK显示名称
+ * @param  sdi_name: SDI显示名称
+ * @param  spi: SPI外设
+ * @retval 0-成功，-1-表满
+ */
+int Sim_Pins_AddBus(const char *sck_name, const char *sdi_name, SPI_TypeDef *spi)
+{
+    if (sim_num_sig + 2 > SIM_PINS_SIGNALS)
+    {
+        return -1;
+    }
+    (void)sim_pins_add(sck_name, SIM_PIN_SCK, NULL, 0, spi);
+    (void)sim_pins_add(sdi_name, SIM_PIN_SDI, NULL, 0, spi);
+    return 0;
+}
+
+/**
+ * @brief  在t_ns时刻把信号sig设为level，电平不变时不记录
+ * @param  sig: 信号序号，-1时不记录
+ * @param  level: 新电平
+ * @param  t_ns: 虚拟时间
+ */
+static void sim_pins_set(int sig, uint8_t level, uint64_t t_ns)
+{
+    if (sig < 0 || sim_sig[sig].level == level)
+    {
+        return;
+    }
+    sim_sig[sig].level = level;
+    if (sim_num_ev >= SIM_PINS_EVENTS)
+    {
+        sim_lost++;
+        return;
+    }
+    sim_ev[sim_num_ev].t_ns = t_ns;
+    sim_ev[sim_num_ev].sig = (uint8_t)sig;
+    sim_ev[sim_num_ev].level = level;
+    sim_num_ev++;
+}
+
+/**
+ * @brief  查找SPI总线上指定类型的信号
+ * @param  spi: SPI外设
+ * @param  role: 信号类型
+ * @retval 信号序号，没有时为-1
+ */
+static int sim_pins_find_bus(SPI_TypeDef *spi, Sim_PinRoleTypeDef role)
+{
+    for (uint8_t i = 0; i < sim_num_sig; i++)
+    {
+        if (sim_sig[i].spi == spi && sim_sig[i].role == role)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief  清空记录，从虚拟时间0开始记录
+ * @param  cost: 开销模型
+ * @retval None
+ */
+void Sim_Pins_Start(const Sim_PinsCostTypeDef *cost)
+{
+    sim_cost = *cost;
+    sim_num_ev = 0;
+    sim_lost = 0;
+    sim_now = 0;
+    for (uint8_t i = 0; i < sim_num_sig; i++)
+    {
+        if (sim_sig[i].port != NULL)
+        {
+            sim_sig[i].level = (sim_sig[i].port->ODR & sim_sig[i].pin) != 0U;
+        }
+        sim_start_level[i] = sim_sig[i].level;
+    }
+    sim_active = 1;
+}
+
+/**
+ * @brief  停止记录
+ * @retval None
+ */
+void Sim_Pins_Stop(void)
+{
+    sim_active = 0;
+}
+
+/**
+ * @brief  记录GPIO写入
+ * @param  port: GPIO端口
+ * @param  pins: 引脚掩码
+ * @param  level: 1-高电平，0-低电平
+ * @retval None
+ */
+void Sim_Pins_Gpio(GPIO_TypeDef *port, uint16_t pins, uint8_t level)
+{
+    if (!sim_active)
+    {
+        return;
+    }
+    sim_now += sim_cost.gpio_ns;
+    for (uint8_t i = 0; i < sim_num_sig; i++)
+    {
+        if (sim_sig[i].port == port && (sim_sig[i].pin & pins))
+        {
+            sim_pins_set(i, level, sim_now);
+        }
+    }
+}
+
+/**
+ * @brief  记录一次SPI阻塞传输
+ * @param  hspi: SPI句柄指针
+ * @param  data: 发送的数据
+ * @param  size: 字节数
+ * @retval None
+ */
+void Sim_Pins_Spi(SPI_HandleTypeDef *hspi, const uint8_t *data, uint16_t size)
+{
+    int sck = sim_pins_find_bus(hspi->Instance, SIM_PIN_SCK);
+    int sdi = sim_pins_find_bus(hspi->Instance, SIM_PIN_SDI);
+    uint32_t pclk = (hspi->Instance == SPI1) ? HAL_RCC_GetPCLK2Freq() : HAL_RCC_GetPCLK1Freq();
+    uint32_t div = 2U << ((hspi->Instance->CR1 & SPI_CR1_BR) >> SPI_CR1_BR_Pos);
+    uint64_t t0;
+    uint32_t bits = (uint32_t)size * 8U;
+
+    if (!sim_active)
+    {
+        return;
+    }
+    t0 = sim_now + sim_cost.spi_start_ns;
+
+    /* Mode 0：SCK为低时更新SDI，半个周期后上升沿（器件采样），再半个周期后下降沿；
+     * 边沿时刻按整数ns取整，但不累积误差 */
+    for (uint32_t k = 0; k < bits; k++)
+    {
+        uint8_t bit = (data[k / 8U] >> (7U - k % 8U)) & 1U;
+        uint64_t rise = t0 + ((2U * k + 1U) * (uint64_t)div * 1000000000ULL) / (2U * pclk);
+        uint64_t fall = t0 + ((2U * k + 2U) * (uint64_t)div * 1000000000ULL) / (2U * pclk);
+
+        sim_pins_set(sdi, bit, t0 + ((2U * k) * (uint64_t)div * 1000000000ULL) / (2U * pclk));
+        sim_pins_set(sck, 1, rise);
+        sim_pins_set(sck, 0, fall);
+    }
+    sim_now = t0 + (bits * (uint64_t)div * 1000000000ULL) / pclk + sim_cost.spi_end_ns;
+}
+
+/**
+ * @brief  记录期间读周期计数器，每读一次虚拟时间前进poll_ns
+ * @param  cycles: 输出虚拟时间对应的周期数
+ * @retval 1-正在记录，0-没有记录
+ */
+int Sim_Pins_Cycles(uint32_t *cycles)
+{
+    if (!sim_active)
+    {
+        return 0;
+    }
+    sim_now += sim_cost.poll_ns;
+    *cycles = (uint32_t)(sim_now * (SystemCoreClock / 1000000U) / 1000U);
+    return 1;
+}
+
+/**
+ * @brief  打印一处违例
+ */
+static void sim_pins_violation(const char *param, uint64_t t_ns, int sig, uint64_t got_ns, uint32_t min_ns)
+{
+    printf("  %s violation at %llu ns on %s: %llu ns < %u ns\n", param, (unsigned long long)t_ns,
+           sim_sig[sig].name, (unsigned long long)got_ns, (unsigned)min_ns);
+}
+
+/**
+ * @brief  检查Table4时序，打印每一处违例
+ * @retval 违例数
+ */
+uint32_t Sim_Pins_Check(void)
+{
+    uint64_t fall_t[SIM_PINS_SIGNALS], rise_t[SIM_PINS_SIGNALS], sck_fall_t[SIM_PINS_SIGNALS];
+    uint8_t level[SIM_PINS_SIGNALS], clocked[SIM_PINS_SIGNALS], rose[SIM_PINS_SIGNALS];
+    uint8_t sck_fell[SIM_PINS_SIGNALS], low[SIM_PINS_SIGNALS];
+    uint32_t violations = 0;
+
+    for (uint8_t i = 0; i < sim_num_sig; i++)
+    {
+        level[i] = sim_start_level[i];
+        clocked[i] = 1; // 记录开始前就已拉低的CS不检查tCSS
+        rose[i] = 0;
+        sck_fell[i] = 0;
+        low[i] = 0;
+        fall_t[i] = rise_t[i] = sck_fall_t[i] = 0;
+    }
+
+    for (uint32_t e = 0; e < sim_num_ev; e++)
+    {
+        const Sim_PinEventTypeDef *ev = &sim_ev[e];
+        const Sim_PinTypeDef *s = &sim_sig[ev->sig];
+        uint64_t t = ev->t_ns;
+
+        level[ev->sig] = ev->level;
+        switch (s->role)
+        {
+        case SIM_PIN_SCK:
+            if (ev->level)
+            {
+                /* 第一个SCK上升沿：总线上每个已选中的器件检查tCSS */
+                for (uint8_t i = 0; i < sim_num_sig; i++)
+                {
+                    if (sim_sig[i].role == SIM_PIN_CS && sim_sig[i].spi == s->spi && !level[i] && !clocked[i])
+                    {
+                        clocked[i] = 1;
+                        if (t - fall_t[i] < SIM_T_CSS_NS)
+                        {
+                            sim_pins_violation("tCSS", t, i, t - fall_t[i], SIM_T_CSS_NS);
+                            violations++;
+                        }
+                    }
+                }
+            }
+            else
+            {
+                sck_fell[ev->sig] = 1;
+                sck_fall_t[ev->sig] = t;
+            }
+            break;
+
+        case SIM_PIN_CS:
+            if (ev->level)
+            {
+                int sck = sim_pins_find_bus(s->spi, SIM_PIN_SCK);
+
+                /* 最后一个SCK下降沿之后才能拉高CS；SCK仍为高说明最后一位还没移完 */
+                if (sck >= 0 && level[sck])
+                {
+                    printf("  tCSH violation at %llu ns on %s: SCK still high\n", (unsigned long long)t, s->name);
+                    violations++;
+                }
+                else if (sck >= 0 && sck_fell[sck] && t < sck_fall_t[sck] + SIM_T_CSH_NS)
+                {
+                    sim_pins_violation("tCSH", t, ev->sig, t - sck_fall_t[sck], SIM_T_CSH_NS);
+                    violations++;
+                }
+                rose[ev->sig] = 1;
+                rise_t[ev->sig] = t;
+            }
+            else
+            {
+                if (rose[ev->sig] && t - rise_t[ev->sig] < SIM_T_CSW_NS)
+                {
+                    sim_pins_violation("tCSW", t, ev->sig, t - rise_t[ev->sig], SIM_T_CSW_NS);
+                    violations++;
+                }
+                clocked[ev->sig] = 0;
+                fall_t[ev->sig] = t;
+            }
+            break;
+
+        case SIM_PIN_RS:
+            if (!ev->level)
+            {
+                fall_t[ev->sig] = t;
+                low[ev->sig] = 1;
+            }
+            else if (low[ev->sig])
+            {
+                low[ev->sig] = 0;
+                if (t - fall_t[ev->sig] < SIM_T_RS_NS)
+                {
+                    sim_pins_violation("tRS", t, ev->sig, t - fall_t[ev->sig], SIM_T_RS_NS);
+                    violations++;
+                }
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    if (sim_lost != 0)
+    {
+        printf("  %u transitions not recorded (log full)\n", (unsigned)sim_lost);
+    }
+    return violations;
+}
+
+/**
+ * @brief  解出某根CS对应器件的锁存结果
+ * @param  cs_sig: CS信号序号
+ * @param  rs_sig: 同一器件的RS信号序号，没有时传-1
+ * @param  latch: 输出
+ * @retval None
+ */
+void Sim_Pins_Decode(int cs_sig, int rs_sig, Sim_PinLatchTypeDef *latch)
+{
+    int sck = sim_pins_find_bus(sim_sig[cs_sig].spi, SIM_PIN_SCK);
+    int sdi = sim_pins_find_bus(sim_sig[cs_sig].spi, SIM_PIN_SDI);
+    uint8_t sdi_level = 0;
+    uint8_t cs_level = 1;
+    uint16_t shift = 0;
+    uint32_t bits = 0;
+
+    for (uint8_t ch = 0; ch < 4; ch++)
+    {
+        latch->wiper[ch] = AD840X_MIDSCALE; // 上电为中值
+    }
+    latch->frames = 0;
+    latch->bad = 0;
+
+    for (uint32_t e = 0; e < sim_num_ev; e++)
+    {
+        const Sim_PinEventTypeDef *ev = &sim_ev[e];
+
+        if (ev->sig == sdi)
+        {
+            sdi_level = ev->level;
+        }
+        else if (ev->sig == sck && ev->level && !cs_level)
+        {
+            /* 10位移位寄存器在SCK上升沿移入SDI（Page10 Figure3） */
+            shift = (uint16_t)((shift << 1) | sdi_level);
+            bits++;
+        }
+        else if (ev->sig == cs_sig)
+        {
+            if (ev->level && !cs_level && bits != 0)
+            {
+                if (bits >= 10U)
+                {
+                    latch->wiper[(shift >> 8) & 0x03U] = (uint8_t)shift;
+                    latch->frames++;
+                }
+                else
+                {
+                    latch->bad++;
+                }
+            }
+            cs_level = ev->level;
+            bits = 0;
+        }
+        else if (ev->sig == rs_sig && !ev->level)
+        {
+            for (uint8_t ch = 0; ch < 4; ch++)
+            {
+                latch->wiper[ch] = AD840X_MIDSCALE;
+            }
+        }
+    }
+}
+
+/**
+ * @brief  读取记录
+ * @param  count: 输出电平变化数
+ * @retval 电平变化数组
+ */
+const Sim_PinEventTypeDef *Sim_Pins_Events(uint32_t *count)
+{
+    *count = sim_num_ev;
+    return sim_ev;
+}
+
+/**
+ * @brief  读取信号表
+ * @param  count: 输出信号数
+ * @retval 信号数组
+ */
+const Sim_PinTypeDef *Sim_Pins_Signals(uint8_t *count)
+{
+    *count = sim_num_sig;
+    return sim_sig;
+}
+
+/**
+ * @brief  把记录写成VCD波形文件
+ * @param  path: 文件路径
+ * @retval 0-成功，-1-文件无法打开
+ */
+int Sim_Pins_WriteVcd(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    uint64_t last = 0;
+
+    if (f == NULL)
+    {
+        return -1;
+    }
+
+    /* 信号标识符用'!'开始的可打印字符，每个信号一个字符 */
+    fprintf(f, "$version AD840X sim_pins $end\n$timescale 1ns $end\n$scope module ad840x $end\n");
+    for (uint8_t i = 0; i < sim_num_sig; i++)
+    {
+        fprintf(f, "$var wire 1 %c %s $end\n", '!' + i, sim_sig[i].name);
+    }
+    fprintf(f, "$upscope $end\n$enddefinitions $end\n#0\n$dumpvars\n");
+    for (uint8_t i = 0; i < sim_num_sig; i++)
+    {
+        fprintf(f, "%u%c\n", sim_start_level[i], '!' + i);
+    }
+    fprintf(f, "$end\n");
+
+    /* 同一时刻的变化只写一个时间标记 */
+    for (uint32_t e = 0; e < sim_num_ev; e++)
+    {
+        if (sim_ev[e].t_ns != last)
+        {
+            last = sim_ev[e].t_ns;
+            fprintf(f, "#%llu\n", (unsigned long long)last);
+        }
+        fprintf(f, "%u%c\n", sim_ev[e].level, '!' + sim_ev[e].sig);
+    }
+
+    fclose(f);
+    return 0;
+}
@@ -0,0 +1,190 @@
+/*
+ * AD840X系列数字电位器驱动库 - Linux仿真用引脚级总线模型
+ * 雪豹  编写   github.com/2827700630
+ *
+ * 启动后，替身HAL库的HAL_GPIO_WritePin和HAL_SPI_Transmit(Receive)不再只改寄存器，
+ * 而是在虚拟时间轴上记录每一次CS、SCK、SDI、RS、SHDN电平变化：
+ *    - GPIO写入：调用开销gpio_ns之后引脚变化
+ *    - SPI传输：开销spi_start_ns之后按CR1的BR分频和PCLK逐位产生SDI/SCK（Mode 0，MSB先发），
+ *      最后一个SCK下降沿之后再过spi_end_ns返回（HAL等BSY清零）
+ *    - AD840X_Time_Now()每读一次前进poll_ns，驱动的纳秒延时循环按虚拟时间结束
+ * 记录结束后按数据手册Page10 Table4检查tCSS、tCSH、tCSW、tRS，并按SCK上升沿采样SDI，
+ * 在CS上升沿解出每片器件锁存的通道值，与驱动写入的值比较；也可以写成VCD文件用GTKWave查看。
+ *
+ * 只覆盖HAL阻塞后端（AD840X_Init在SPI没有DMA时使用），直接写寄存器的后端不经过替身函数。
+ * 单线程使用。
+ */
+
+#ifndef __SIM_PINS_H
+#define __SIM_PINS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "AD840X.h"
+
+/* Page10 Table4 时序要求（ns，最小值） */
+#define SIM_T_CSS_NS 10 // CS下降沿到SCK上升沿
+#define SIM_T_CSH_NS 0  // SCK下降沿到CS上升沿
+#define SIM_T_CSW_NS 10 // CS高电平宽度
+#define SIM_T_RS_NS 50  // RS低电平宽度
+
+/* 最多记录的信号数和电平变化数 */
+#define SIM_PINS_SIGNALS 16
+#define SIM_PINS_EVENTS 65536
+
+    /* 信号类型 */
+    typedef enum
+    {
+        SIM_PIN_CS = 0,
+        SIM_PIN_RS,
+        SIM_PIN_SHDN,
+        SIM_PIN_SCK,
+        SIM_PIN_SDI
+    } Sim_PinRoleTypeDef;
+
+    /* 虚拟时间开销模型（ns） */
+    typedef struct
+    {
+        uint32_t gpio_ns;      // 一次GPIO写入（函数调用到引脚变化）
+        uint32_t spi_start_ns; // SPI传输函数开始到第一位数据出现在SDI
+        uint32_t spi_end_ns;   // 最后一个SCK下降沿到传输函数返回
+        uint32_t poll_ns;      // 读一次周期计数器（延时循环一圈）
+    } Sim_PinsCostTypeDef;
+
+    /* 一个信号 */
+    typedef struct
+    {
+        const char *name;        // 显示名称
+        GPIO_TypeDef *port;      // GPIO端口，SCK/SDI为NULL
+        uint16_t pin;            // GPIO引脚
+        SPI_TypeDef *spi;        // 所在SPI总线（CS、SCK、SDI）
+        Sim_PinRoleTypeDef role; // 信号类型
+        uint8_t level;           // 当前电平
+    } Sim_PinTypeDef;
+
+    /* 一次电平变化 */
+    typedef struct
+    {
+        uint64_t t_ns; // 虚拟时间
+        uint8_t sig;   // 信号序号
+        uint8_t level; // 新电平
+    } Sim_PinEventTypeDef;
+
+    /* 从CS上升沿解出的锁存结果 */
+    typedef struct
+    {
+        uint8_t wiper[4]; // 各通道锁存值（RS复位为中值）
+        uint32_t frames;  // CS上升沿锁存次数
+        uint32_t bad;     // CS为低期间移入的位数不足10位的帧数
+    } Sim_PinLatchTypeDef;
+
+    /* HAL阻塞调用的典型开销（72MHz，约：GPIO 8周期，HAL_SPI_Transmit进入/退出约100/30周期） */
+    extern const Sim_PinsCostTypeDef Sim_Pins_CostHAL;
+    /* 寄存器直接访问的下限：每次引脚或DR写入1个周期 */
+    extern const Sim_PinsCostTypeDef Sim_Pins_CostFast;
+
+    /**
+     * @brief  添加一个GPIO信号（CS、RS、SHDN）
+     * @param  name: 显示名称
+     * @param  role: 信号类型
+     * @param  port: GPIO端口
+     * @param  pin: GPIO引脚
+     * @param  spi: CS所在的SPI总线，RS/SHDN传NULL
+     * @retval 信号序号，表满时为-1
+     */
+    int Sim_Pins_AddGpio(const char *name, Sim_PinRoleTypeDef role, GPIO_TypeDef *port, uint16_t pin,
+                         SPI_TypeDef *spi);
+
+    /**
+     * @brief  添加一条SPI总线的SCK和SDI信号
+     * @param  sck_name: SCK显示名称
+     * @param  sdi_name: SDI显示名称
+     * @param  spi: SPI外设
+     * @retval 0-成功，-1-表满
+     */
+    int Sim_Pins_AddBus(const char *sck_name, const char *sdi_name, SPI_TypeDef *spi);
+
+    /**
+     * @brief  清空记录，从虚拟时间0开始记录
+     * @param  cost: 开销模型
+     * @retval None
+     */
+    void Sim_Pins_Start(const Sim_PinsCostTypeDef *cost);
+
+    /**
+     * @brief  停止记录，AD840X_Time_Now()恢复为主机时钟
+     * @retval None
+     */
+    void Sim_Pins_Stop(void);
+
+    /**
+     * @brief  检查Table4时序，打印每一处违例
+     * @retval 违例数
+     */
+    uint32_t Sim_Pins_Check(void);
+
+    /**
+     * @brief  解出某根CS对应器件的锁存结果
+     * @param  cs_sig: CS信号序号（Sim_Pins_AddGpio的返回值）
+     * @param  rs_sig: 同一器件的RS信号序号，没有时传-1
+     * @param  latch: 输出
+     * @retval None
+     */
+    void Sim_Pins_Decode(int cs_sig, int rs_sig, Sim_PinLatchTypeDef *latch);
+
+    /**
+     * @brief  读取记录
+     * @param  count: 输出电平变化数
+     * @retval 电平变化数组（按时间排序）
+     */
+    const Sim_PinEventTypeDef *Sim_Pins_Events(uint32_t *count);
+
+    /**
+     * @brief  读取信号表
+     * @param  count: 输出信号数
+     * @retval 信号数组
+     */
+    const Sim_PinTypeDef *Sim_Pins_Signals(uint8_t *count);
+
+    /**
+     * @brief  把记录写成VCD波形文件（GTKWave等查看）
+     * @param  path: 文件路径
+     * @retval 0-成功，-1-文件无法打开
+     * @note   时间单位1ns，每个信号一个1位wire，名称与添加时相同
+     */
+    int Sim_Pins_WriteVcd(const char *path);
+
+    /* ---- 以下由sim_hal.c的替身函数调用 ---- */
+
+    /**
+     * @brief  记录GPIO写入
+     * @param  port: GPIO端口
+     * @param  pins: 引脚掩码
+     * @param  level: 1-高电平，0-低电平
+     * @retval None
+     */
+    void Sim_Pins_Gpio(GPIO_TypeDef *port, uint16_t pins, uint8_t level);
+
+    /**
+     * @brief  记录一次SPI阻塞传输
+     * @param  hspi: SPI句柄指针
+     * @param  data: 发送的数据
+     * @param  size: 字节数
+     * @retval None
+     */
+    void Sim_Pins_Spi(SPI_HandleTypeDef *hspi, const uint8_t *data, uint16_t size);
+
+    /**
+     * @brief  记录期间读周期计数器
+     * @param  cycles: 输出虚拟时间对应的周期数
+     * @retval 1-正在记录，cycles有效；0-没有记录
+     */
+    int Sim_Pins_Cycles(uint32_t *cycles);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __SIM_PINS_H */
@@ -0,0 +1,400 @@
+/*
+ * AD840X系列数字电位器驱动库 - Linux多任务仿真
+ * 雪豹  编写
+ *
+ * 用pthread线程代替RTOS任务，检查AD840X_USE_RTOS下多个任务同时写同一SPI总线上的设备时
+ * CS帧不会交错。3片AD8403挂在一条仿真总线上，4个任务各自负责每片器件的一个通道；
+ * dma模式下另有一个线程扮演DMA完成中断；queue模式下任务只向AD840X_Queue提交命令，
+ * 由一个总线工作线程统一发送；mailbox模式下任务向每通道的邮箱覆盖写入，工作线程只发最新值。
+ * async模式下用AD840X_WriteAsync提交并注入DMA错误，检查每次写入都恰好回调一次、出错数一致。
+ * urgent模式先检查AD840X_WriteUrgent插队和取消同通道普通帧的顺序，再让一个线程在DMA流量中
+ * 不断发紧急静音，检查紧急帧前面最多只有1个普通帧。
+ * 结束后检查每个通道的最终值、帧数和总线冲突次数。
+ * 编译运行方法见Sim/README.md
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include "AD840X.h"
+#include "AD840X_Transport.h"
+#include "AD840X_Transport_Stub.h"
+#include "AD840X_Queue.h"
+
+#define SIM_DEVICES 3
+#define SIM_TASKS 4 // AD8403的4个通道，每个任务一个
+#define SIM_ITERATIONS 2000
+
+static AD840X_StubBusTypeDef sim_bus;
+static AD840X_StubTypeDef sim_stub[SIM_DEVICES];
+static AD840X_HandleTypeDef sim_dev[SIM_DEVICES];
+static uint8_t sim_expected[SIM_DEVICES][SIM_TASKS];
+static volatile uint8_t sim_stop;
+static uint8_t sim_use_queue;
+static uint8_t sim_use_mailbox;
+static AD840X_QueueTypeDef sim_queue;
+static volatile uint32_t sim_queue_full;
+static uint8_t sim_use_async;
+static volatile uint32_t sim_cb_ok;
+static volatile uint32_t sim_cb_error;
+static volatile uint32_t sim_wait_error;
+static uint8_t sim_use_urgent;
+static volatile uint32_t sim_urgent_sent;
+static volatile uint32_t sim_urgent_full;
+static volatile uint8_t sim_mute_stop;
+
+/* 异步写完成回调，在扮演中断的线程中调用 */
+static void sim_on_done(AD840X_HandleTypeDef *hdev, HAL_StatusTypeDef status, void *arg)
+{
+    (void)hdev;
+    (void)arg;
+    __atomic_fetch_add(status == HAL_OK ? &sim_cb_ok : &sim_cb_error, 1U, __ATOMIC_RELAXED);
+}
+
+/* 任务：反复写每片器件上属于自己的通道 */
+static void *sim_task(void *arg)
+{
+    uint8_t channel = (uint8_t)(uintptr_t)arg;
+    AD840X_TokenTypeDef token = {NULL, 0, HAL_OK, AD840X_PRIORITY_NORMAL};
+
+    for (uint32_t i = 0; i < SIM_ITERATIONS; i++)
+    {
+        for (uint8_t d = 0; d < SIM_DEVICES; d++)
+        {
+            uint8_t value = (uint8_t)(i * 7U + channel * 50U + d);
+
+            if (sim_use_async)
+            {
+                token = AD840X_WriteAsync(&sim_dev[d], channel, value, sim_on_done, NULL);
+            }
+            else if (sim_use_mailbox)
+            {
+                AD840X_Mailbox_Post(&sim_dev[d], channel, value);
+            }
+            else if (sim_use_queue)
+            {
+                /* 生产者不阻塞：队列满时由调用者决定重试还是放弃，这里让出CPU后重试 */
+                while (!AD840X_Queue_Push(&sim_queue, &sim_dev[d], channel, value))
+                {
+                    sim_queue_full++;
+                    sched_yield();
+                }
+            }
+            else
+            {
+                AD840X_Write(&sim_dev[d], channel, value);
+            }
+            sim_expected[d][channel] = value;
+        }
+
+        /* 定期等待最近一帧，模拟流水线控制环 */
+        if (sim_use_async && (i % 64U == 63U || i == SIM_ITERATIONS - 1U))
+        {
+            if (AD840X_Token_Wait(&token) == HAL_BUSY)
+            {
+                __atomic_fetch_add(&sim_wait_error, 1U, __ATOMIC_RELAXED);
+            }
+        }
+    }
+    return NULL;
+}
+
+/* 紧急静音：在其他任务的DMA流量中不断插入高优先级帧 */
+static void *sim_mute(void *arg)
+{
+    (void)arg;
+    for (uint32_t i = 0; !sim_mute_stop; i++)
+    {
+        AD840X_TokenTypeDef token = AD840X_WriteUrgent(&sim_dev[i % SIM_DEVICES], (uint8_t)(i % SIM_TASKS), 0, 1,
+                                                       NULL, NULL);
+
+        if (token.bus != NULL)
+        {
+            sim_urgent_sent++;
+        }
+        else
+        {
+            sim_urgent_full++;
+        }
+        sched_yield();
+    }
+    return NULL;
+}
+
+/**
+ * 紧急写入的顺序：队列中有6帧（第1帧正在发送）时对通道1发紧急静音，
+ * 应在当前帧之后立即发出，并取消排队中的3个通道1普通帧
+ */
+static uint8_t sim_urgent_order(void)
+{
+    static const uint8_t channels[6] = {0, 1, 2, 3, 1, 1};
+    static const uint8_t values[6] = {10, 11, 12, 13, 21, 22};
+    static const uint8_t expect[4] = {10, 0, 12, 13};
+    AD840X_TokenTypeDef urgent;
+    AD840X_TokenTypeDef queued[6];
+    uint8_t ok = 1;
+
+    for (uint8_t i = 0; i < 6; i++)
+    {
+        queued[i] = AD840X_WriteAsync(&sim_dev[0], channels[i], values[i], NULL, NULL);
+    }
+    urgent = AD840X_WriteUrgent(&sim_dev[0], AD840X_CHANNEL_2, 0, 1, NULL, NULL);
+
+    /* 当前帧完成后紧急帧应该已经在发送 */
+    AD840X_StubBus_RunDMA(&sim_bus);
+    ok = ok && sim_stub[0].wiper[0] == 10 && AD840X_Token_Poll(&urgent) == HAL_BUSY;
+    AD840X_StubBus_RunDMA(&sim_bus);
+    ok = ok && sim_stub[0].wiper[1] == 0 && AD840X_Token_Poll(&urgent) == HAL_OK;
+    while (AD840X_StubBus_RunDMA(&sim_bus))
+    {
+    }
+
+    for (uint8_t c = 0; c < 4; c++)
+    {
+        ok = ok && sim_stub[0].wiper[c] == expect[c];
+    }
+    ok = ok && AD840X_Token_Poll(&queued[1]) == HAL_ERROR && AD840X_Token_Poll(&queued[2]) == HAL_OK;
+    ok = ok && sim_stub[0].frames == 4 && sim_dev[0].bus->flushed == 3 && sim_dev[0].bus->urgent_wait_max == 1;
+
+    printf("urgent order: wiper = %u %u %u %u  frames = %u  flushed = %u  wait = %u  %s\n",
+           sim_stub[0].wiper[0], sim_stub[0].wiper[1], sim_stub[0].wiper[2], sim_stub[0].wiper[3],
+           (unsigned)sim_stub[0].frames, (unsigned)sim_dev[0].bus->flushed, (unsigned)sim_dev[0].bus->urgent_wait_max,
+           ok ? "ok" : "FAILED");
+
+    /* 恢复初始状态，继续多任务测试 */
+    AD840X_Stub_Init(&sim_stub[0]);
+    sim_dev[0].bus->flushed = 0;
+    sim_dev[0].bus->urgent_wait_max = 0;
+    sim_dev[0].bus->frames = 0;
+    sim_dev[0].stats.frames = 0;
+    sim_dev[0].stats.bytes = 0;
+    return ok;
+}
+
+/* 扮演DMA完成中断 */
+static void *sim_isr(void *arg)
+{
+    (void)arg;
+    while (!sim_stop)
+    {
+        if (!AD840X_StubBus_RunDMA(&sim_bus))
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/* 总线工作者：取出命令队列（或邮箱）并发送 */
+static uint16_t sim_worker_pass(void)
+{
+    static AD840X_HandleTypeDef *const devs[SIM_DEVICES] = {&sim_dev[0], &sim_dev[1], &sim_dev[2]};
+
+    return sim_use_mailbox ? AD840X_Mailbox_Process(devs, SIM_DEVICES) : AD840X_Queue_Process(&sim_queue);
+}
+
+static void *sim_worker(void *arg)
+{
+    (void)arg;
+    while (!sim_stop)
+    {
+        if (sim_worker_pass() == 0)
+        {
+            sched_yield();
+        }
+    }
+    sim_worker_pass();
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    static const uint16_t cs_pins[SIM_DEVICES] = {AD840X_CS1_Pin, AD840X_CS2_Pin, AD840X_CS3_Pin};
+    uint8_t use_dma = (argc > 1 && (strcmp(argv[1], "dma") == 0 || strcmp(argv[1], "async") == 0 ||
+                                    strcmp(argv[1], "urgent") == 0));
+    const AD840X_TransportTypeDef *transport = use_dma ? &AD840X_Transport_StubBus_DMA : &AD840X_Transport_StubBus;
+    pthread_t tasks[SIM_TASKS];
+    pthread_t isr;
+    pthread_t worker;
+    pthread_t mute;
+    uint8_t order_ok = 1;
+    uint32_t mismatches = 0;
+    uint32_t frames = 0;
+
+    AD840X_StubBus_Init(&sim_bus);
+    for (uint8_t d = 0; d < SIM_DEVICES; d++)
+    {
+        AD840X_Stub_Init(&sim_stub[d]);
+        AD840X_StubBus_Attach(&sim_bus, &sim_stub[d], cs_pins[d]);
+        AD840X_Init_Transport(&sim_dev[d], transport, &sim_bus, AD840X_CS1_GPIO_Port, cs_pins[d]);
+    }
+
+    sim_use_queue = (argc > 1 && strcmp(argv[1], "queue") == 0);
+    sim_use_mailbox = (argc > 1 && strcmp(argv[1], "mailbox") == 0);
+    sim_use_async = (argc > 1 && strcmp(argv[1], "async") == 0);
+    sim_use_urgent = (argc > 1 && strcmp(argv[1], "urgent") == 0);
+    if (sim_use_urgent)
+    {
+        order_ok = sim_urgent_order();
+    }
+    if (sim_use_async)
+    {
+        sim_bus.dma_fail_every = 97; // 注入DMA传输错误
+    }
+    AD840X_Queue_Init(&sim_queue);
+
+    if (use_dma)
+    {
+        pthread_create(&isr, NULL, sim_isr, NULL);
+    }
+    if (sim_use_queue || sim_use_mailbox)
+    {
+        pthread_create(&worker, NULL, sim_worker, NULL);
+    }
+    if (sim_use_urgent)
+    {
+        pthread_create(&mute, NULL, sim_mute, NULL);
+    }
+    for (uintptr_t t = 0; t < SIM_TASKS; t++)
+    {
+        pthread_create(&tasks[t], NULL, sim_task, (void *)t);
+    }
+    for (uint8_t t = 0; t < SIM_TASKS; t++)
+    {
+        pthread_join(tasks[t], NULL);
+    }
+    if (sim_use_queue || sim_use_mailbox)
+    {
+        sim_stop = 1;
+        pthread_join(worker, NULL);
+    }
+    if (sim_use_urgent)
+    {
+        sim_mute_stop = 1;
+        pthread_join(mute, NULL);
+    }
+    for (uint8_t d = 0; d < SIM_DEVICES; d++)
+    {
+        AD840X_WaitIdle(&sim_dev[d]);
+    }
+    if (use_dma)
+    {
+        sim_stop = 1;
+        pthread_join(isr, NULL);
+    }
+
+    for (uint8_t d = 0; d < SIM_DEVICES; d++)
+    {
+        for (uint8_t c = 0; c < SIM_TASKS; c++)
+        {
+            mismatches += (sim_stub[d].wiper[c] != sim_expected[d][c]);
+        }
+        frames += sim_stub[d].frames;
+    }
+
+    printf("mode = %s  rtos = %s\n", sim_use_async ? "async" : sim_use_urgent ? "urgent" : use_dma ? "dma" : (sim_use_queue ? "queue" : (sim_use_mailbox ? "mailbox" : "blocking")),
+#ifdef AD840X_USE_RTOS
+           "on"
+#else
+           "off"
+#endif
+    );
+    printf("frames = %u (submitted %u)  collisions = %u  wiper mismatches = %u\n", (unsigned)frames,
+           (unsigned)(SIM_DEVICES * SIM_TASKS * SIM_ITERATIONS), (unsigned)sim_bus.collisions, (unsigned)mismatches);
+
+    if (sim_use_queue)
+    {
+        printf("queue full retries = %u  dropped = %u\n", (unsigned)sim_queue_full, (unsigned)sim_queue.dropped);
+    }
+
+    /* 运行统计：各设备的帧数、出错数之和与总线一致 */
+    if (use_dma)
+    {
+        AD840X_StatsTypeDef dev_stats;
+        AD840X_BusStatsTypeDef bus_stats;
+        uint32_t dev_frames = 0;
+        uint32_t dev_errors = 0;
+
+        for (uint8_t d = 0; d < SIM_DEVICES; d++)
+        {
+            AD840X_GetStats(&sim_dev[d], &dev_stats);
+            dev_frames += dev_stats.frames;
+            dev_errors += dev_stats.errors;
+        }
+        AD840X_GetBusStats(&sim_dev[0], &bus_stats);
+        printf("stats: device frames = %u  bus frames = %u  errors = %u  queue waits = %u  bus busy = %u us\n",
+               (unsigned)dev_frames, (unsigned)bus_stats.frames, (unsigned)dev_errors, (unsigned)bus_stats.waits,
+               (unsigned)bus_stats.busy_us);
+        if (dev_frames != bus_stats.frames || dev_errors != bus_stats.errors ||
+            bus_stats.frames + bus_stats.errors != frames)
+        {
+            return 1;
+        }
+    }
+
+    /* 异步模式：出错的帧没有移出新数据，最终值可能不一致，只检查回调次数和出错数 */
+    if (sim_use_async)
+    {
+        uint32_t submitted = SIM_DEVICES * SIM_TASKS * SIM_ITERATIONS;
+
+        printf("callbacks ok = %u  error = %u  injected = %u  bus errors = %u  wait errors = %u\n",
+               (unsigned)sim_cb_ok, (unsigned)sim_cb_error, (unsigned)sim_bus.dma_failed,
+               (unsigned)sim_dev[0].bus->errors, (unsigned)sim_wait_error);
+        return (sim_cb_ok + sim_cb_error == submitted && sim_cb_error == sim_bus.dma_failed &&
+                sim_dev[0].bus->errors == sim_bus.dma_failed && sim_bus.collisions == 0 &&
+                sim_wait_error == 0)
+                   ? 0
+                   : 1;
+    }
+
+    /* 紧急模式：静音帧覆盖了部分通道，检查帧数守恒和紧急帧的等待帧数 */
+    if (sim_use_urgent)
+    {
+        uint32_t submitted = SIM_DEVICES * SIM_TASKS * SIM_ITERATIONS;
+
+        printf("urgent sent = %u  queue full = %u  flushed = %u  errors = %u  max normal frames ahead = %u\n",
+               (unsigned)sim_urgent_sent, (unsigned)sim_urgent_full, (unsigned)sim_dev[0].bus->flushed,
+               (unsigned)sim_dev[0].bus->errors, (unsigned)sim_dev[0].bus->urgent_wait_max);
+        return (order_ok && frames == submitted + sim_urgent_sent - sim_dev[0].bus->flushed &&
+                sim_dev[0].bus->urgent_wait_max <= 1 && sim_bus.collisions == 0)
+                   ? 0
+                   : 1;
+    }
+
+    /* dma模式：模拟掉电重启（所有通道回到中值），用AD840X_Restore批量恢复 */
+    if (use_dma && !sim_use_async && !sim_use_urgent)
+    {
+        AD840X_HandleTypeDef *const devs[SIM_DEVICES] = {&sim_dev[0], &sim_dev[1], &sim_dev[2]};
+        uint32_t restore_mismatches = 0;
+        uint16_t restored = 0;
+        uint32_t us;
+
+        for (uint8_t d = 0; d < SIM_DEVICES; d++)
+        {
+            AD840X_Stub_Init(&sim_stub[d]);
+        }
+        sim_stop = 0;
+        pthread_create(&isr, NULL, sim_isr, NULL);
+        us = AD840X_Restore(devs, SIM_DEVICES, 1, &restored);
+        sim_stop = 1;
+        pthread_join(isr, NULL);
+
+        for (uint8_t d = 0; d < SIM_DEVICES; d++)
+        {
+            for (uint8_t c = 0; c < SIM_TASKS; c++)
+            {
+                restore_mismatches += (sim_stub[d].wiper[c] != sim_expected[d][c]);
+            }
+        }
+        printf("restore frames = %u  time = %u us  mismatches = %u\n", restored, (unsigned)us,
+               (unsigned)restore_mismatches);
+        mismatches += restore_mismatches;
+    }
+
+    /* 邮箱模式丢弃中间值，帧数不超过提交数即可 */
+    if (sim_use_mailbox)
+    {
+        return (frames <= SIM_DEVICES * SIM_TASKS * SIM_ITERATIONS && sim_bus.collisions == 0 && mismatches == 0) ? 0 : 1;
+    }
+    return (frames == SIM_DEVICES * SIM_TASKS * SIM_ITERATIONS && sim_bus.collisions == 0 && mismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,206 @@
+/*
+ * AD840X系列数字电位器驱动库 - Linux引脚级时序检查
+ * 雪豹  编写
+ *
+ * 真实的AD840X.c通过HAL阻塞后端驱动3片器件（AD8403带SHDN/RS、AD8402带SHDN/RS、AD8400只有CS），
+ * 共用hspi1的SCK/SDI。替身HAL库把每次GPIO写入和SPI传输记录成虚拟时间轴上的电平变化（见sim_pins.h），
+ * 结束后按Page10 Table4检查tCSS、tCSH、tCSW、tRS，并从波形解出每片器件锁存的通道值与写入值比较。
+ *
+ * 参数：
+ *    hal   按HAL库调用的典型开销推进虚拟时间（默认）
+ *    fast  每次引脚或SPI写入只用1个周期，相当于直接写寄存器的后端能达到的下限
+ *    0-7   SPI1的BR分频设置（默认1即4分频，与CubeMX配置一致）
+ *    x.vcd 把波形写入该文件，用GTKWave查看帧的排布、CS间隔、器件之间的间隔和总线空闲时间
+ * 没有违例且锁存值全部正确时返回0。编译运行方法见Sim/README.md
+ */
+#include <stdio.h>
+#include <string.h>
+#include "AD840X.h"
+#include "sim_pins.h"
+
+#define SIM_DEVICES 3
+
+static AD840X_HandleTypeDef sim_dev[SIM_DEVICES];
+static uint8_t sim_expected[SIM_DEVICES][4];
+static int sim_cs[SIM_DEVICES];
+static int sim_rs[SIM_DEVICES];
+
+/* 写入并记录期望值 */
+static void sim_write(uint8_t dev, uint8_t channel, uint8_t value)
+{
+    AD840X_Write(&sim_dev[dev], channel, value);
+    sim_expected[dev][channel] = value;
+}
+
+/* 复位后所有通道为中值 */
+static void sim_reset(uint8_t dev)
+{
+    AD840X_Reset(&sim_dev[dev]);
+    memset(sim_expected[dev], AD840X_MIDSCALE, sizeof(sim_expected[dev]));
+}
+
+/* 总线效率：SCK实际走时钟的时间占比，以及一帧CS拉高到下一帧CS拉低的平均间隔 */
+static void sim_bus_summary(const Sim_PinEventTypeDef *events, uint32_t count, uint32_t sck_hz)
+{
+    uint8_t num;
+    const Sim_PinTypeDef *sig = Sim_Pins_Signals(&num);
+    uint64_t end = count ? events[count - 1].t_ns : 0;
+    uint64_t rises = 0, gap_sum = 0, last_rise = 0;
+    uint32_t gaps = 0;
+    uint8_t have_rise = 0;
+
+    for (uint32_t e = 0; e < count; e++)
+    {
+        Sim_PinRoleTypeDef role = sig[events[e].sig].role;
+
+        if (role == SIM_PIN_SCK && events[e].level)
+        {
+            rises++;
+        }
+        else if (role == SIM_PIN_CS && events[e].level)
+        {
+            last_rise = events[e].t_ns;
+            have_rise = 1;
+        }
+        else if (role == SIM_PIN_CS && have_rise)
+        {
+            gap_sum += events[e].t_ns - last_rise;
+            gaps++;
+        }
+    }
+
+    uint64_t clocked = rises * 1000000000ULL / sck_hz;
+    printf("bus: %llu clocks, clocked %llu ns of %llu ns (%.1f%%), mean CS gap %llu ns\n",
+           (unsigned long long)rises, (unsigned long long)clocked, (unsigned long long)end,
+           end ? 100.0 * (double)clocked / (double)end : 0.0, gaps ? (unsigned long long)(gap_sum / gaps) : 0ULL);
+}
+
+int main(int argc, char **argv)
+{
+    const Sim_PinsCostTypeDef *cost = &Sim_Pins_CostHAL;
+    uint32_t br = 1;
+    uint32_t violations;
+    uint32_t mismatches = 0;
+    uint32_t count;
+    const Sim_PinEventTypeDef *events;
+    AD840X_CommandTypeDef batch[4];
+    const char *vcd = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        size_t len = strlen(argv[i]);
+
+        if (strcmp(argv[i], "fast") == 0)
+        {
+            cost = &Sim_Pins_CostFast;
+        }
+        else if (len > 4 && strcmp(argv[i] + len - 4, ".vcd") == 0)
+        {
+            vcd = argv[i];
+        }
+        else if (argv[i][0] >= '0' && argv[i][0] <= '7')
+        {
+            br = (uint32_t)(argv[i][0] - '0');
+        }
+    }
+    MODIFY_REG(SPI1->CR1, SPI_CR1_BR, br << SPI_CR1_BR_Pos);
+    hspi1.Init.BaudRatePrescaler = br << SPI_CR1_BR_Pos;
+
+    sim_cs[0] = Sim_Pins_AddGpio("cs1", SIM_PIN_CS, AD840X_CS1_GPIO_Port, AD840X_CS1_Pin, SPI1);
+    sim_cs[1] = Sim_Pins_AddGpio("cs2", SIM_PIN_CS, AD840X_CS2_GPIO_Port, AD840X_CS2_Pin, SPI1);
+    sim_cs[2] = Sim_Pins_AddGpio("cs3", SIM_PIN_CS, AD840X_CS3_GPIO_Port, AD840X_CS3_Pin, SPI1);
+    (void)Sim_Pins_AddBus("sck", "sdi", SPI1);
+    sim_rs[0] = Sim_Pins_AddGpio("rs1", SIM_PIN_RS, AD840X_RS1_GPIO_Port, AD840X_RS1_Pin, NULL);
+    sim_rs[1] = Sim_Pins_AddGpio("rs2", SIM_PIN_RS, AD840X_RS2_GPIO_Port, AD840X_RS2_Pin, NULL);
+    sim_rs[2] = -1;
+    (void)Sim_Pins_AddGpio("shdn1", SIM_PIN_SHDN, AD840X_SHDN1_GPIO_Port, AD840X_SHDN1_Pin, NULL);
+    (void)Sim_Pins_AddGpio("shdn2", SIM_PIN_SHDN, AD840X_SHDN2_GPIO_Port, AD840X_SHDN2_Pin, NULL);
+
+    Sim_Pins_Start(cost);
+
+    /* 上电：器件为中值 */
+    AD840X_Init(&sim_dev[0], &hspi1, AD840X_CS1_GPIO_Port, AD840X_CS1_Pin);
+    AD840X_Config_Pins(&sim_dev[0], AD840X_SHDN1_GPIO_Port, AD840X_SHDN1_Pin, AD840X_RS1_GPIO_Port, AD840X_RS1_Pin);
+    AD840X_Init(&sim_dev[1], &hspi1, AD840X_CS2_GPIO_Port, AD840X_CS2_Pin);
+    AD840X_Config_Pins(&sim_dev[1], AD840X_SHDN2_GPIO_Port, AD840X_SHDN2_Pin, AD840X_RS2_GPIO_Port, AD840X_RS2_Pin);
+    AD840X_Config_Model(&sim_dev[1], AD840X_MODEL_AD8402);
+    AD840X_Init(&sim_dev[2], &hspi1, AD840X_CS3_GPIO_Port, AD840X_CS3_Pin);
+    AD840X_Config_Model(&sim_dev[2], AD840X_MODEL_AD8400);
+    for (uint8_t i = 0; i < SIM_DEVICES; i++)
+    {
+        memset(sim_expected[i], AD840X_MIDSCALE, sizeof(sim_expected[i]));
+    }
+
+    /* 逐个写入、同一器件背靠背写入（tCSW）、不同器件交替写入 */
+    sim_write(0, AD840X_CHANNEL_1, 0x00);
+    sim_write(0, AD840X_CHANNEL_2, 0xFF);
+    sim_write(0, AD840X_CHANNEL_3, 0xA5);
+    sim_write(0, AD840X_CHANNEL_4, 0x5A);
+    sim_write(1, AD840X_CHANNEL_1, 0x11);
+    sim_write(2, AD840X_CHANNEL_1, 0x22);
+    sim_write(1, AD840X_CHANNEL_2, 0x33);
+
+    /* 批量写入 */
+    batch[0] = (AD840X_CommandTypeDef){&sim_dev[0], AD840X_CHANNEL_1, 0x44};
+    batch[1] = (AD840X_CommandTypeDef){&sim_dev[1], AD840X_CHANNEL_1, 0x55};
+    batch[2] = (AD840X_CommandTypeDef){&sim_dev[2], AD840X_CHANNEL_1, 0x66};
+    batch[3] = (AD840X_CommandTypeDef){&sim_dev[0], AD840X_CHANNEL_4, 0x77};
+    AD840X_WriteBatch(batch, 4);
+    sim_expected[0][AD840X_CHANNEL_1] = 0x44;
+    sim_expected[1][AD840X_CHANNEL_1] = 0x55;
+    sim_expected[2][AD840X_CHANNEL_1] = 0x66;
+    sim_expected[0][AD840X_CHANNEL_4] = 0x77;
+
+    /* RS复位（tRS），没有RS引脚的AD8400改用SPI写中值 */
+    sim_reset(0);
+    sim_reset(2);
+    sim_write(0, AD840X_CHANNEL_2, 0x99);
+
+    /* 断电再唤醒，唤醒后等待ts再写入 */
+    AD840X_Shutdown(&sim_dev[1], 0);
+    AD840X_Shutdown(&sim_dev[1], 1);
+    sim_write(1, AD840X_CHANNEL_2, 0xEE);
+
+    Sim_Pins_Stop();
+    events = Sim_Pins_Events(&count);
+    printf("SPI1 BR=%u (SCK %u Hz), %s cost model: %u transitions in %llu ns\n", (unsigned)br,
+           (unsigned)(HAL_RCC_GetPCLK2Freq() >> (br + 1U)), cost == &Sim_Pins_CostFast ? "fast" : "hal",
+           (unsigned)count, count ? (unsigned long long)events[count - 1].t_ns : 0ULL);
+
+    sim_bus_summary(events, count, HAL_RCC_GetPCLK2Freq() >> (br + 1U));
+    if (vcd != NULL)
+    {
+        printf("%s %s\n", Sim_Pins_WriteVcd(vcd) == 0 ? "waveform written to" : "cannot write", vcd);
+    }
+
+    violations = Sim_Pins_Check();
+    printf("Table4 violations = %u\n", (unsigned)violations);
+
+    for (uint8_t i = 0; i < SIM_DEVICES; i++)
+    {
+        Sim_PinLatchTypeDef latch;
+
+        Sim_Pins_Decode(sim_cs[i], sim_rs[i], &latch);
+        printf("dev%u latched %3u %3u %3u %3u  frames = %u  short frames = %u\n", i + 1U, latch.wiper[0],
+               latch.wiper[1], latch.wiper[2], latch.wiper[3], (unsigned)latch.frames, (unsigned)latch.bad);
+        for (uint8_t ch = 0; ch < sim_dev[i].num_channels; ch++)
+        {
+            if (latch.wiper[ch] != sim_expected[i][ch])
+            {
+                printf("  dev%u channel %u: expected %u\n", i + 1U, ch, sim_expected[i][ch]);
+                mismatches++;
+            }
+        }
+        mismatches += latch.bad;
+    }
+
+    /* 检查器自检：不经过驱动直接给出一个过短的RS脉冲，必须报告恰好一处tRS违例 */
+    Sim_Pins_Start(&Sim_Pins_CostFast);
+    HAL_GPIO_WritePin(AD840X_RS1_GPIO_Port, AD840X_RS1_Pin, GPIO_PIN_RESET);
+    HAL_GPIO_WritePin(AD840X_RS1_GPIO_Port, AD840X_RS1_Pin, GPIO_PIN_SET);
+    Sim_Pins_Stop();
+    uint32_t selftest = Sim_Pins_Check();
+    printf("checker self-test (short RS pulse): %s\n", selftest == 1U ? "ok" : "FAILED");
+
+    return (violations == 0U && mismatches == 0U && selftest == 1U) ? 0 : 1;
+}
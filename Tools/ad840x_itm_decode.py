@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+AD840X系列数字电位器驱动库 - ITM遥测解码
+雪豹  编写   github.com/2827700630
+
+把SWO数据流（OpenOCD/J-Link/pyOCD保存的原始字节）中AD840X_ITM_PORT端口的数据包转成CSV：
+    time_s,device,channel,value
+time_s由16位时间戳展开得到，从第一个数据包开始计时。数据包格式见Core/Inc/AD840X_ITM.h。
+
+用法：
+    python3 Tools/ad840x_itm_decode.py swo.bin > wiper.csv
+    python3 Tools/ad840x_itm_decode.py --follow swo.bin      # 文件还在写入时持续输出
+    nc localhost 3344 | python3 Tools/ad840x_itm_decode.py -  # 从标准输入读取
+只使用Python 3标准库。
+"""
+
+import argparse
+import os
+import sys
+import time
+
+
+class ItmParser:
+    """按ARMv7-M ITM/DWT协议（ARM DDI 0403 Appendix D4）拆包，只返回激励端口包"""
+
+    def __init__(self):
+        self.state = self._header
+        self.zeros = 0
+        self.need = 0
+        self.payload = []
+        self.port = None
+        self.overflows = 0
+
+    def feed(self, data):
+        """输入一段字节，逐个返回(port, payload)"""
+        for byte in data:
+            packet = self.state(byte)
+            if packet is not None:
+                yield packet
+
+    def _header(self, byte):
+        if byte == 0x00:
+            self.zeros += 1  # 同步包的前导0
+            return None
+        if byte == 0x80 and self.zeros >= 5:
+            self.zeros = 0  # 同步包
+            return None
+        self.zeros = 0
+        if byte == 0x70:
+            self.overflows += 1  # 溢出包：调试器这一侧丢了数据
+            return None
+        if byte & 0x0F == 0x00 or byte & 0x0B == 0x08 or byte in (0x94, 0xB4):
+            # 本地时间戳、扩展包、全局时间戳：有续接位时跳过后续字节
+            if byte & 0x80:
+                self.state = self._continuation
+            return None
+        size = byte & 0x03
+        if size == 0:
+            return None  # 保留的头字节
+        self.need = (1, 2, 4)[size - 1]
+        self.payload = []
+        # bit2为1是DWT硬件源包（PC采样、事件计数等），同样长度但不属于激励端口
+        self.port = None if byte & 0x04 else byte >> 3
+        self.state = self._payload
+        return None
+
+    def _continuation(self, byte):
+        if not byte & 0x80:
+            self.state = self._header
+        return None
+
+    def _payload(self, byte):
+        self.payload.append(byte)
+        if len(self.payload) < self.need:
+            return None
+        self.state = self._header
+        if self.port is None:
+            return None
+        value = 0
+        for i, b in enumerate(self.payload):
+            value |= b << (8 * i)
+        return self.port, value, self.need
+
+
+def read_chunks(stream, follow):
+    """读取数据流，follow为真时到达文件末尾后等待新数据"""
+    while True:
+        data = stream.read(4096)
+        if data:
+            yield data
+        elif follow:
+            time.sleep(0.05)
+        else:
+            return
+
+
+def main():
+    parser = argparse.ArgumentParser(description="AD840X ITM遥测解码，输出CSV")
+    parser.add_argument("input", help="SWO原始数据文件，'-'为标准输入")
+    parser.add_argument("--port", type=int, default=8, help="激励端口，与AD840X_ITM_PORT一致（默认8）")
+    parser.add_argument("--hz", type=float, default=72e6, help="时间戳计数频率，即SystemCoreClock（默认72000000）")
+    parser.add_argument("--shift", type=int, default=10, help="与AD840X_ITM_TS_SHIFT一致（默认10）")
+    parser.add_argument("--follow", action="store_true", help="到达文件末尾后继续等待新数据")
+    args = parser.parse_args()
+
+    stream = sys.stdin.buffer if args.input == "-" else open(args.input, "rb")
+    itm = ItmParser()
+    tick = float(1 << args.shift) / args.hz
+    last = None
+    ticks = 0
+    count = 0
+
+    # 逐行刷新，输出可以直接接到绘图脚本
+    sys.stdout.write("time_s,device,channel,value\n")
+    try:
+        for chunk in read_chunks(stream, args.follow):
+            for port, word, size in itm.feed(chunk):
+                if port != args.port or size != 4:
+                    continue
+                stamp = word >> 16
+                # 两个数据包间隔小于一个回绕周期（默认约0.93秒）时展开结果正确
+                if last is not None:
+                    ticks += (stamp - last) & 0xFFFF
+                last = stamp
+                sys.stdout.write("%.6f,%u,%u,%u\n" % (ticks * tick, (word >> 10) & 0x3F, (word >> 8) & 0x03,
+                                                      word & 0xFF))
+                sys.stdout.flush()
+                count += 1
+    except KeyboardInterrupt:
+        pass
+    except BrokenPipeError:
+        # 下游（head等）提前退出，按Python文档的做法丢弃剩余输出
+        os.dup2(os.open(os.devnull, os.O_WRONLY), sys.stdout.fileno())
+    finally:
+        if stream is not sys.stdin.buffer:
+            stream.close()
+
+    sys.stderr.write("%d packets, %d overflows\n" % (count, itm.overflows))
+
+
+if __name__ == "__main__":
+    main()